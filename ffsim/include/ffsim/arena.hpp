@@ -0,0 +1,283 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace ffsim
+{
+
+/**
+ * @brief Usage statistics of a scratch arena.
+ */
+struct ArenaStats {
+    size_t bytes_in_use = 0;   ///< Bytes handed out and not yet released
+    size_t peak_bytes = 0;     ///< High-water mark of bytes_in_use
+    size_t capacity_bytes = 0; ///< Bytes held in blocks
+    size_t allocations = 0;    ///< Number of allocate() calls
+    size_t blocks = 0;         ///< Number of blocks requested from the heap
+    size_t resets = 0;         ///< Number of full resets
+};
+
+/**
+ * @brief Bump allocator for kernel scratch memory.
+ *
+ * Allocation advances an offset inside a heap block; memory is only released
+ * by rewinding to an earlier mark or by a full reset. When a block is exhausted
+ * a new one at least as large as the current capacity is appended, and a full
+ * reset coalesces all blocks into one, so after the first call of a kernel the
+ * arena serves every request from a single block without touching the heap.
+ *
+ * Only trivially destructible types may be placed in the arena. An arena is not
+ * thread safe; kernels use the per-thread instance of thread_arena() through
+ * ArenaScope.
+ */
+class Arena
+{
+  public:
+    /// Alignment of every allocation, one cache line.
+    static constexpr size_t alignment = 64;
+
+    /// Position in the arena to rewind to.
+    struct Mark {
+        size_t block;
+        size_t offset;
+        size_t in_use;
+    };
+
+    /**
+     * @brief Creates an empty arena.
+     * @param block_bytes Size of the first block, allocated on first use
+     */
+    explicit Arena(size_t block_bytes = size_t(1) << 16) : block_bytes_(block_bytes)
+    {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        release();
+    }
+
+    /**
+     * @brief Returns uninitialized storage for n objects of type T.
+     */
+    template <typename T>
+    T *allocate(size_t n)
+    {
+        static_assert(
+            std::is_trivially_destructible_v<T>, "arena objects are never destroyed"
+        );
+        static_assert(alignof(T) <= alignment, "over-aligned type");
+        return static_cast<T *>(allocate_bytes(n * sizeof(T)));
+    }
+
+    /**
+     * @brief Returns the current position, to be passed to rewind().
+     */
+    Mark mark() const
+    {
+        return {current_, offset_, stats_.bytes_in_use};
+    }
+
+    /**
+     * @brief Releases everything allocated since the mark was taken.
+     */
+    void rewind(const Mark &mark)
+    {
+        current_ = mark.block;
+        offset_ = mark.offset;
+        stats_.bytes_in_use = mark.in_use;
+    }
+
+    /**
+     * @brief Releases all allocations, merging the blocks into a single one.
+     */
+    void reset()
+    {
+        if (blocks_.size() > 1) {
+            size_t capacity = stats_.capacity_bytes;
+            release();
+            append_block(capacity);
+        }
+        current_ = 0;
+        offset_ = 0;
+        stats_.bytes_in_use = 0;
+        ++stats_.resets;
+    }
+
+    /**
+     * @brief Returns the usage statistics of this arena.
+     */
+    const ArenaStats &stats() const
+    {
+        return stats_;
+    }
+
+    /**
+     * @brief Returns the largest peak usage reached by any arena in the process.
+     */
+    static size_t global_peak_bytes()
+    {
+        return global_peak().load(std::memory_order_relaxed);
+    }
+
+  private:
+    friend class ArenaScope;
+
+    struct Block {
+        std::byte *data;
+        size_t size;
+    };
+
+    static std::atomic<size_t> &global_peak()
+    {
+        static std::atomic<size_t> peak{0};
+        return peak;
+    }
+
+    void *allocate_bytes(size_t bytes)
+    {
+        ++stats_.allocations;
+        for (;;) {
+            if (current_ < blocks_.size()) {
+                const Block &block = blocks_[current_];
+                size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+                if (start <= block.size && bytes <= block.size - start) {
+                    stats_.bytes_in_use += start + bytes - offset_;
+                    offset_ = start + bytes;
+                    update_peak();
+                    return block.data + start;
+                }
+                // The tail of this block stays unused until the next rewind.
+                stats_.bytes_in_use += block.size - offset_;
+                ++current_;
+                offset_ = 0;
+                continue;
+            }
+            append_block(std::max({block_bytes_, stats_.capacity_bytes, bytes}));
+        }
+    }
+
+    void append_block(size_t size)
+    {
+        auto *data = static_cast<std::byte *>(
+            ::operator new(size, std::align_val_t(alignment))
+        );
+        blocks_.push_back({data, size});
+        stats_.capacity_bytes += size;
+        ++stats_.blocks;
+    }
+
+    void release()
+    {
+        for (const auto &block : blocks_) {
+            ::operator delete(block.data, std::align_val_t(alignment));
+        }
+        blocks_.clear();
+        stats_.capacity_bytes = 0;
+    }
+
+    void update_peak()
+    {
+        if (stats_.bytes_in_use <= stats_.peak_bytes) {
+            return;
+        }
+        stats_.peak_bytes = stats_.bytes_in_use;
+        size_t global = global_peak().load(std::memory_order_relaxed);
+        while (global < stats_.peak_bytes &&
+               !global_peak().compare_exchange_weak(
+                   global, stats_.peak_bytes, std::memory_order_relaxed
+               )) {
+        }
+    }
+
+    size_t block_bytes_;
+    std::vector<Block> blocks_;
+    size_t current_ = 0;
+    size_t offset_ = 0;
+    size_t depth_ = 0;
+    ArenaStats stats_;
+};
+
+/**
+ * @brief Returns the scratch arena of the calling thread.
+ */
+Arena &thread_arena()
+{
+    thread_local Arena arena;
+    return arena;
+}
+
+/**
+ * @brief Scoped scratch allocations from the arena of the calling thread.
+ *
+ * Everything allocated through a scope is released when it is destroyed.
+ * Scopes nest: an inner scope rewinds to where it started, and the outermost
+ * scope, i.e. the top-level kernel call, resets the arena.
+ */
+class ArenaScope
+{
+  public:
+    ArenaScope() : arena_(thread_arena()), mark_(arena_.mark())
+    {
+        ++arena_.depth_;
+    }
+
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    ~ArenaScope()
+    {
+        if (--arena_.depth_ == 0) {
+            arena_.reset();
+        } else {
+            arena_.rewind(mark_);
+        }
+    }
+
+    /**
+     * @brief Returns uninitialized storage for n objects of type T.
+     */
+    template <typename T>
+    T *allocate(size_t n)
+    {
+        return arena_.allocate<T>(n);
+    }
+
+  private:
+    Arena &arena_;
+    Arena::Mark mark_;
+};
+
+/**
+ * @brief Returns the arena statistics of the calling thread.
+ */
+ArenaStats arena_stats()
+{
+    return thread_arena().stats();
+}
+
+} // namespace ffsim
+
+#endif // ARENA_HPP
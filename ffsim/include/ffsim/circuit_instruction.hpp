@@ -16,10 +16,17 @@
 #define CIRCUIT_INSTRUCTION_HPP
 
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <vector>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace ffsim
 {
 
@@ -41,6 +48,75 @@ struct CircuitInstruction {
     std::vector<double> params;
 };
 
+/// Builder of one independent segment of a circuit.
+using SegmentBuilder = std::function<std::vector<CircuitInstruction>()>;
+
+/**
+ * @brief Builds circuit segments concurrently and concatenates them in order.
+ *
+ * Each builder runs as an OpenMP task into its own buffer, so the result is the
+ * same as running them one after another. Called inside a parallel region,
+ * e.g. from another segment, the tasks join the enclosing team. The exception
+ * of the first failing segment is rethrown once all tasks have finished.
+ *
+ * @param builders Segment builders, in circuit order
+ * @return The instructions of all segments, in builder order
+ */
+std::vector<CircuitInstruction>
+build_segments_concurrently(const std::vector<SegmentBuilder> &builders)
+{
+    const size_t n = builders.size();
+    std::vector<std::vector<CircuitInstruction>> segments(n);
+    std::vector<std::exception_ptr> errors(n);
+    auto run = [&](size_t k) {
+        try {
+            segments[k] = builders[k]();
+        } catch (...) {
+            errors[k] = std::current_exception();
+        }
+    };
+#ifdef _OPENMP
+    if (n > 1 && omp_in_parallel()) {
+        for (size_t k = 0; k < n; ++k) {
+#pragma omp task default(shared) firstprivate(k)
+            run(k);
+        }
+#pragma omp taskwait
+    } else if (n > 1 && omp_get_max_threads() > 1) {
+#pragma omp parallel
+#pragma omp single
+        for (size_t k = 0; k < n; ++k) {
+#pragma omp task default(shared) firstprivate(k)
+            run(k);
+        }
+    } else {
+        for (size_t k = 0; k < n; ++k) {
+            run(k);
+        }
+    }
+#else
+    for (size_t k = 0; k < n; ++k) {
+        run(k);
+    }
+#endif
+    size_t total = 0;
+    for (size_t k = 0; k < n; ++k) {
+        if (errors[k]) {
+            std::rethrow_exception(errors[k]);
+        }
+        total += segments[k].size();
+    }
+    std::vector<CircuitInstruction> instructions;
+    instructions.reserve(total);
+    for (auto &segment : segments) {
+        instructions.insert(
+            instructions.end(), std::make_move_iterator(segment.begin()),
+            std::make_move_iterator(segment.end())
+        );
+    }
+    return instructions;
+}
+
 } // namespace ffsim
 
 #endif // CIRCUIT_INSTRUCTION_HPP
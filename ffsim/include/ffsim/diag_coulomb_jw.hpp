@@ -16,7 +16,10 @@
 #define DIAG_COULOMB_JW_HPP
 
 #include "circuit_instruction.hpp"
+#include "ffsim/arena.hpp"
 #include "gates/diag_coulomb.hpp"
+#include <algorithm>
+#include <array>
 #include <optional>
 #include <vector>
 
@@ -79,6 +82,35 @@ class DiagCoulombEvolutionJW
     }
 
   private:
+    /**
+     * @brief Returns views of the (aa, ab, bb) interaction matrices.
+     *
+     * A single matrix serves all three; missing triple entries are zero
+     * matrices allocated from the scratch arena of the caller.
+     *
+     * @param scope Arena scope of the calling builder
+     * @return Views of the three matrices
+     */
+    std::array<Map<const MatrixXcd>, 3> interaction_matrices(ArenaScope &scope) const
+    {
+        const auto n = static_cast<Index>(norb);
+        auto view = [&](size_t k) {
+            const MatrixXcd *matrix = nullptr;
+            if (mat.type == MatType::Single) {
+                matrix = &mat.single;
+            } else if (mat.triple[k].has_value()) {
+                matrix = &mat.triple[k].value();
+            }
+            if (matrix != nullptr) {
+                return Map<const MatrixXcd>(matrix->data(), n, n);
+            }
+            Complex *zeros = scope.allocate<Complex>(norb * norb);
+            std::fill(zeros, zeros + norb * norb, Complex(0.0));
+            return Map<const MatrixXcd>(zeros, n, n);
+        };
+        return {view(0), view(1), view(2)};
+    }
+
     /**
      * @brief Implements the number-representation based evolution (number
      * operators).
@@ -91,32 +123,8 @@ class DiagCoulombEvolutionJW
     {
         std::vector<CircuitInstruction> instructions;
 
-        auto [mat_aa, mat_ab, mat_bb] = [&]() {
-            if (mat.type == MatType::Single) {
-                return std::make_tuple(mat.single, mat.single, mat.single);
-            } else {
-                return std::make_tuple(
-                    mat.triple[0].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    ),
-                    mat.triple[1].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    ),
-                    mat.triple[2].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    )
-                );
-            }
-        }();
+        ArenaScope scope;
+        auto [mat_aa, mat_ab, mat_bb] = interaction_matrices(scope);
 
         for (int sigma = 0; sigma < 2; ++sigma) {
             const auto &this_mat = (sigma == 0) ? mat_aa : mat_bb;
@@ -230,40 +238,16 @@ class DiagCoulombEvolutionJW
     std::vector<CircuitInstruction>
     diag_coulomb_evolution_z_rep_jw(const std::vector<uint32_t> &qubits) const
     {
-        auto [mat_aa, mat_ab, mat_bb] = [&]() {
-            if (mat.type == MatType::Single) {
-                return std::make_tuple(mat.single, mat.single, mat.single);
-            } else {
-                return std::make_tuple(
-                    mat.triple[0].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    ),
-                    mat.triple[1].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    ),
-                    mat.triple[2].value_or(
-                        MatrixXcd::Zero(
-                            static_cast<Eigen::Index>(norb),
-                            static_cast<Eigen::Index>(norb)
-                        )
-                    )
-                );
-            }
-        }();
+        ArenaScope scope;
+        auto [mat_aa, mat_ab, mat_bb] = interaction_matrices(scope);
 
         std::vector<CircuitInstruction> instructions;
 
         for (size_t i = 0; i < 2 * norb; ++i) {
             for (size_t j = i + 1; j < 2 * norb; ++j) {
-                const MatrixXcd this_mat = (i < norb && j < norb)     ? mat_aa
-                                           : (i >= norb && j >= norb) ? mat_bb
-                                                                      : mat_ab;
+                const auto &this_mat = (i < norb && j < norb)     ? mat_aa
+                                       : (i >= norb && j >= norb) ? mat_bb
+                                                                  : mat_ab;
                 const auto val = this_mat(
                     static_cast<Index>(i % norb), static_cast<Index>(j % norb)
                 );
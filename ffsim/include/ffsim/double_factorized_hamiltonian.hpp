@@ -0,0 +1,88 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef DOUBLE_FACTORIZED_HAMILTONIAN_HPP
+#define DOUBLE_FACTORIZED_HAMILTONIAN_HPP
+
+#include "ffsim/fcidump.hpp"
+#include "ffsim/linalg/double_factorized_decomp.hpp"
+#include <Eigen/Dense>
+#include <optional>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+
+/**
+ * @brief Molecular Hamiltonian in double-factorized form.
+ *
+ * H = sum_{pq,sigma} h'_pq a^dagger_{p,sigma} a_{q,sigma}
+ *     + 1/2 sum_k sum_{ij} Z^k_ij n^k_i n^k_j + constant,
+ *
+ * where n^k_i is the (spin-summed) number operator of orbital i in the basis
+ * rotated by U_k. Each term k is exactly a diagonal Coulomb evolution with
+ * orbital rotation U_k, and h' absorbs the one-body part of the reordered
+ * two-body operator.
+ */
+struct DoubleFactorizedHamiltonian {
+    uint64_t norb = 0;                       ///< Number of spatial orbitals
+    MatrixXd one_body_tensor;                ///< Modified one-body tensor h'
+    std::vector<MatrixXd> diag_coulomb_mats; ///< Z_k = lambda_k lambda_k^T
+    std::vector<MatrixXd> orbital_rotations; ///< U_k, eigenvectors of L^k
+    double constant = 0.0;                   ///< Constant energy shift
+
+    /**
+     * @brief Builds the double-factorized Hamiltonian from FCIDUMP integrals.
+     *
+     * Uses the Cholesky vectors of `fcidump` if it was already factorized and
+     * computes them with the given tolerance otherwise.
+     *
+     * @param fcidump Molecular integrals
+     * @param tol Cholesky tolerance on the largest residual diagonal integral
+     * @param max_vecs Optional limit on the number of terms
+     * @return The double-factorized Hamiltonian
+     */
+    static DoubleFactorizedHamiltonian from_fcidump(
+        const FCIDump &fcidump, double tol = 1e-8,
+        std::optional<size_t> max_vecs = std::nullopt
+    )
+    {
+        std::vector<MatrixXd> cholesky_vecs =
+            fcidump.eri.empty()
+                ? fcidump.cholesky_vecs
+                : linalg::cholesky_eri(fcidump.eri, fcidump.norb, tol, max_vecs);
+
+        DoubleFactorizedHamiltonian hamiltonian;
+        hamiltonian.norb = fcidump.norb;
+        hamiltonian.constant = fcidump.constant;
+        hamiltonian.one_body_tensor = fcidump.one_body;
+        for (const auto &vec : cholesky_vecs) {
+            // 1/2 sum (pq|rs) E_pq E_rs leaves -1/2 sum_q (pq|qs) in the one-body part
+            hamiltonian.one_body_tensor -= 0.5 * vec * vec;
+        }
+
+        auto [eigs, orbital_rotations] = linalg::double_factorized(cholesky_vecs);
+        for (size_t k = 0; k < eigs.size(); ++k) {
+            hamiltonian.diag_coulomb_mats.push_back(eigs[k] * eigs[k].transpose());
+        }
+        hamiltonian.orbital_rotations = std::move(orbital_rotations);
+        return hamiltonian;
+    }
+};
+
+} // namespace ffsim
+
+#endif // DOUBLE_FACTORIZED_HAMILTONIAN_HPP
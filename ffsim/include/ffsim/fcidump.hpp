@@ -0,0 +1,351 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef FCIDUMP_HPP
+#define FCIDUMP_HPP
+
+#include <Eigen/Dense>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ffsim/linalg/double_factorized_decomp.hpp"
+
+namespace ffsim
+{
+
+using namespace Eigen;
+
+/**
+ * @brief Returns the packed index of the symmetric pair (p, q).
+ * @param p First orbital index
+ * @param q Second orbital index
+ * @return Index of (max(p, q), min(p, q)) in lower-triangular packed storage
+ */
+inline size_t pair_index(size_t p, size_t q)
+{
+    return (p >= q) ? p * (p + 1) / 2 + q : q * (q + 1) / 2 + p;
+}
+
+/**
+ * @brief Molecular integrals read from an FCIDUMP file.
+ *
+ * The two-electron integrals (pq|rs) are stored with their full 8-fold
+ * permutational symmetry, i.e. as the lower triangle of the symmetric
+ * npair x npair matrix over orbital pairs, npair = norb * (norb + 1) / 2.
+ * This takes roughly norb^4 / 8 doubles instead of the norb^4 of a dense tensor.
+ *
+ * For large active spaces the integrals can be replaced by low-rank Cholesky
+ * vectors with factorize(), which needs O(norb^2 * L) memory with L typically a
+ * few times norb.
+ */
+struct FCIDump {
+    uint64_t norb = 0;                   ///< Number of spatial orbitals
+    uint64_t nelec = 0;                  ///< Total number of electrons
+    int64_t ms2 = 0;                     ///< Twice the spin projection
+    std::vector<int> orbsym;             ///< Point-group irrep label of each orbital
+    double constant = 0.0;               ///< Nuclear repulsion and frozen-core energy
+    MatrixXd one_body;                   ///< One-electron integrals h_pq (norb x norb)
+    std::vector<double> eri;             ///< Packed two-electron integrals (pq|rs)
+    std::vector<MatrixXd> cholesky_vecs; ///< (pq|rs) ~ sum_k L^k_pq L^k_rs
+
+    /**
+     * @brief Returns the number of symmetric orbital pairs.
+     */
+    size_t npair() const
+    {
+        return norb * (norb + 1) / 2;
+    }
+
+    /**
+     * @brief Returns the two-electron integral (pq|rs) in chemists' notation.
+     */
+    double two_body(size_t p, size_t q, size_t r, size_t s) const
+    {
+        if (eri.empty()) {
+            double value = 0.0;
+            for (const auto &vec : cholesky_vecs) {
+                value += vec(p, q) * vec(r, s);
+            }
+            return value;
+        }
+        return eri[pair_index(pair_index(p, q), pair_index(r, s))];
+    }
+
+    /**
+     * @brief Replaces the packed integrals by their Cholesky vectors.
+     * @param tol Tolerance on the largest residual diagonal integral (pq|pq)
+     * @param max_vecs Optional limit on the number of Cholesky vectors
+     */
+    void factorize(double tol, std::optional<size_t> max_vecs = std::nullopt)
+    {
+        cholesky_vecs = linalg::cholesky_eri(eri, norb, tol, max_vecs);
+        std::vector<double>().swap(eri);
+    }
+
+    /**
+     * @brief Transforms the integrals to a new orbital basis.
+     *
+     * h -> C^T h C and L^k -> C^T L^k C. Only the factorized form is supported,
+     * which keeps the transform at O(norb^3 * L) instead of O(norb^5).
+     *
+     * @param coeffs Orbital coefficients C, old orbitals in rows
+     * @throws std::logic_error if the integrals are not factorized
+     */
+    void transform(const MatrixXd &coeffs)
+    {
+        if (!eri.empty()) {
+            throw std::logic_error("FCIDump::transform requires factorize() first");
+        }
+        one_body = coeffs.transpose() * one_body * coeffs;
+        for (auto &vec : cholesky_vecs) {
+            vec = coeffs.transpose() * vec * coeffs;
+        }
+    }
+
+    /**
+     * @brief Relabels the orbitals, orbital j of the result being orbital
+     * order[j] of the input.
+     *
+     * Packed integrals are gathered into a new array and Cholesky vectors are
+     * permuted in place; orbital symmetry labels follow their orbitals.
+     *
+     * @param order Permutation of 0, ..., norb - 1
+     * @throws std::invalid_argument if order has the wrong length
+     */
+    void permute_orbitals(const std::vector<size_t> &order)
+    {
+        if (order.size() != norb) {
+            throw std::invalid_argument("orbital order has the wrong length");
+        }
+        const auto n = static_cast<Index>(norb);
+        MatrixXd permuted(n, n);
+        for (Index p = 0; p < n; ++p) {
+            for (Index q = 0; q < n; ++q) {
+                permuted(p, q) = one_body(order[p], order[q]);
+            }
+        }
+        one_body = permuted;
+        for (auto &vec : cholesky_vecs) {
+            for (Index p = 0; p < n; ++p) {
+                for (Index q = 0; q < n; ++q) {
+                    permuted(p, q) = vec(order[p], order[q]);
+                }
+            }
+            vec = permuted;
+        }
+        if (!eri.empty()) {
+            std::vector<double> packed(eri.size());
+            for (size_t p = 0; p < norb; ++p) {
+                for (size_t q = 0; q <= p; ++q) {
+                    size_t pq = pair_index(order[p], order[q]);
+                    for (size_t r = 0; r < norb; ++r) {
+                        for (size_t s = 0; s <= r; ++s) {
+                            packed[pair_index(pair_index(p, q), pair_index(r, s))] =
+                                eri[pair_index(pq, pair_index(order[r], order[s]))];
+                        }
+                    }
+                }
+            }
+            eri.swap(packed);
+        }
+        if (orbsym.size() == norb) {
+            std::vector<int> labels(norb);
+            for (size_t p = 0; p < norb; ++p) {
+                labels[p] = orbsym[order[p]];
+            }
+            orbsym.swap(labels);
+        }
+    }
+
+    /**
+     * @brief Returns the (alpha, beta) electron counts from NELEC and MS2.
+     */
+    std::pair<uint64_t, uint64_t> nelec_pair() const
+    {
+        auto n_alpha = static_cast<uint64_t>((static_cast<int64_t>(nelec) + ms2) / 2);
+        return {n_alpha, nelec - n_alpha};
+    }
+};
+
+/**
+ * @brief Reads molecular integrals from an FCIDUMP file.
+ *
+ * Both the `&END` and `/` namelist terminators are accepted. Indices in the
+ * file are 1-based; lines with k = l = 0 hold one-electron integrals and the
+ * line with all indices 0 holds the core energy.
+ *
+ * @param filename Path to the FCIDUMP file
+ * @return Parsed integrals
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+FCIDump load_fcidump(const std::string &filename)
+{
+    std::ifstream input(filename);
+    if (!input.is_open()) {
+        throw std::runtime_error("Could not open FCIDUMP file: " + filename);
+    }
+
+    // The header is a Fortran namelist that may span several lines.
+    std::string header;
+    std::string line;
+    while (std::getline(input, line)) {
+        std::string upper = line;
+        for (auto &ch : upper) {
+            ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        }
+        header += upper + ",";
+        if (upper.find("&END") != std::string::npos ||
+            upper.find('/') != std::string::npos) {
+            break;
+        }
+    }
+
+    FCIDump fcidump;
+    auto read_values = [&](const std::string &key) {
+        std::vector<int64_t> values;
+        auto pos = header.find(key + "=");
+        if (pos == std::string::npos) {
+            return values;
+        }
+        pos += key.size() + 1;
+        while (pos < header.size()) {
+            while (pos < header.size() && (header[pos] == ' ' || header[pos] == ',')) {
+                ++pos;
+            }
+            size_t end = pos;
+            while (end < header.size() &&
+                   (std::isdigit(static_cast<unsigned char>(header[end])) ||
+                    header[end] == '-')) {
+                ++end;
+            }
+            if (end == pos) {
+                break;
+            }
+            values.push_back(std::stoll(header.substr(pos, end - pos)));
+            pos = end;
+        }
+        return values;
+    };
+
+    auto norb = read_values("NORB");
+    auto nelec = read_values("NELEC");
+    if (norb.empty() || nelec.empty()) {
+        throw std::runtime_error(
+            "NORB or NELEC missing in FCIDUMP header: " + filename
+        );
+    }
+    fcidump.norb = static_cast<uint64_t>(norb[0]);
+    fcidump.nelec = static_cast<uint64_t>(nelec[0]);
+    if (auto ms2 = read_values("MS2"); !ms2.empty()) {
+        fcidump.ms2 = ms2[0];
+    }
+    for (auto sym : read_values("ORBSYM")) {
+        fcidump.orbsym.push_back(static_cast<int>(sym));
+    }
+
+    const auto n = static_cast<Index>(fcidump.norb);
+    fcidump.one_body = MatrixXd::Zero(n, n);
+    const size_t npair = fcidump.npair();
+    fcidump.eri.assign(npair * (npair + 1) / 2, 0.0);
+
+    while (std::getline(input, line)) {
+        // Accept Fortran double-precision exponents such as 1.0D-03.
+        for (auto &ch : line) {
+            if (ch == 'D' || ch == 'd') {
+                ch = 'E';
+            }
+        }
+        std::istringstream fields(line);
+        double value;
+        int64_t p, q, r, s;
+        if (!(fields >> value)) {
+            continue;
+        }
+        if (!(fields >> p >> q >> r >> s)) {
+            throw std::runtime_error(
+                "Malformed integral line in FCIDUMP file: " + filename
+            );
+        }
+        if (p > 0 && r > 0) {
+            fcidump.eri[pair_index(
+                pair_index(p - 1, q - 1), pair_index(r - 1, s - 1)
+            )] = value;
+        } else if (p > 0) {
+            fcidump.one_body(p - 1, q - 1) = value;
+            fcidump.one_body(q - 1, p - 1) = value;
+        } else {
+            fcidump.constant = value;
+        }
+    }
+    return fcidump;
+}
+
+/**
+ * @brief Writes molecular integrals to an FCIDUMP file.
+ *
+ * Two-electron integrals are written once per 8-fold symmetry class, and only
+ * if nonzero; factorized integrals are expanded from their Cholesky vectors.
+ *
+ * @param fcidump Integrals to write
+ * @param filename Path of the output file
+ * @throws std::runtime_error if the file cannot be opened
+ */
+void write_fcidump(const FCIDump &fcidump, const std::string &filename)
+{
+    std::ofstream output(filename);
+    if (!output.is_open()) {
+        throw std::runtime_error("Could not open FCIDUMP file: " + filename);
+    }
+    output << "&FCI NORB=" << fcidump.norb << ",NELEC=" << fcidump.nelec
+           << ",MS2=" << fcidump.ms2 << ",\n ORBSYM=";
+    for (size_t p = 0; p < fcidump.norb; ++p) {
+        output << (p < fcidump.orbsym.size() ? fcidump.orbsym[p] : 1) << ",";
+    }
+    output << "\n ISYM=1,\n&END\n";
+    output << std::scientific << std::setprecision(16);
+
+    for (size_t p = 0; p < fcidump.norb; ++p) {
+        for (size_t q = 0; q <= p; ++q) {
+            for (size_t r = 0; r <= p; ++r) {
+                for (size_t s = 0; s <= (r == p ? q : r); ++s) {
+                    double value = fcidump.two_body(p, q, r, s);
+                    if (value != 0.0) {
+                        output << value << " " << p + 1 << " " << q + 1 << " "
+                               << r + 1 << " " << s + 1 << "\n";
+                    }
+                }
+            }
+        }
+    }
+    for (size_t p = 0; p < fcidump.norb; ++p) {
+        for (size_t q = 0; q <= p; ++q) {
+            double value = fcidump.one_body(p, q);
+            if (value != 0.0) {
+                output << value << " " << p + 1 << " " << q + 1 << " 0 0\n";
+            }
+        }
+    }
+    output << fcidump.constant << " 0 0 0 0\n";
+}
+
+} // namespace ffsim
+
+#endif // FCIDUMP_HPP
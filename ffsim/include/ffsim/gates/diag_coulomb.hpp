@@ -15,6 +15,7 @@
 #ifndef DIAG_COULOMB_HPP
 #define DIAG_COULOMB_HPP
 
+#include "ffsim/arena.hpp"
 #include "ffsim/linalg/givens.hpp"
 #include "orbital_rotation.hpp"
 #include <Eigen/Dense>
@@ -165,10 +166,18 @@ void apply_diag_coulomb_evolution_in_place_num_rep(
     const size_t n_alpha = occupations_a.empty() ? 0 : occupations_a[0].size();
     const size_t n_beta = occupations_b.empty() ? 0 : occupations_b[0].size();
 
-    ArrayXcd alpha_phases = ArrayXcd::Zero(static_cast<Index>(dim_a));
-    ArrayXcd beta_phases = ArrayXcd::Zero(static_cast<Index>(dim_b));
-    ArrayXXcd phase_map =
-        ArrayXXcd::Ones(static_cast<Index>(dim_a), static_cast<Index>(dim_b));
+    ArenaScope scope;
+    Map<ArrayXcd> alpha_phases(
+        scope.allocate<Complex>(dim_a), static_cast<Index>(dim_a)
+    );
+    Map<ArrayXcd> beta_phases(
+        scope.allocate<Complex>(dim_b), static_cast<Index>(dim_b)
+    );
+    Map<ArrayXXcd> phase_map(
+        scope.allocate<Complex>(dim_a * norb), static_cast<Index>(dim_a),
+        static_cast<Index>(norb)
+    );
+    phase_map.setOnes();
 
     for (size_t i = 0; i < dim_b; ++i) {
         Complex phase = 1.0;
@@ -215,17 +224,28 @@ void apply_diag_coulomb_evolution_in_place_z_rep(
     const std::vector<int64_t> &strings_a, const std::vector<int64_t> &strings_b
 )
 {
-    MatrixXcd mat_exp_aa_conj = mat_exp.aa.conjugate();
-    MatrixXcd mat_exp_ab_conj = mat_exp.ab.conjugate();
-    MatrixXcd mat_exp_bb_conj = mat_exp.bb.conjugate();
-
     size_t dim_a = vec.rows();
     size_t dim_b = vec.cols();
+    const auto n = static_cast<Index>(norb);
 
-    ArrayXcd alpha_phases = ArrayXcd::Zero(static_cast<Index>(dim_a));
-    ArrayXcd beta_phases = ArrayXcd::Zero(static_cast<Index>(dim_b));
-    ArrayXXcd phase_map =
-        ArrayXXcd::Ones(static_cast<Index>(dim_a), static_cast<Index>(norb));
+    ArenaScope scope;
+    Map<MatrixXcd> mat_exp_aa_conj(scope.allocate<Complex>(norb * norb), n, n);
+    Map<MatrixXcd> mat_exp_ab_conj(scope.allocate<Complex>(norb * norb), n, n);
+    Map<MatrixXcd> mat_exp_bb_conj(scope.allocate<Complex>(norb * norb), n, n);
+    mat_exp_aa_conj = mat_exp.aa.conjugate();
+    mat_exp_ab_conj = mat_exp.ab.conjugate();
+    mat_exp_bb_conj = mat_exp.bb.conjugate();
+
+    Map<ArrayXcd> alpha_phases(
+        scope.allocate<Complex>(dim_a), static_cast<Index>(dim_a)
+    );
+    Map<ArrayXcd> beta_phases(
+        scope.allocate<Complex>(dim_b), static_cast<Index>(dim_b)
+    );
+    Map<ArrayXXcd> phase_map(
+        scope.allocate<Complex>(dim_a * norb), static_cast<Index>(dim_a), n
+    );
+    phase_map.setOnes();
 
     for (size_t i = 0; i < dim_b; ++i) {
         Complex phase = 1.0;
@@ -249,11 +269,11 @@ void apply_diag_coulomb_evolution_in_place_z_rep(
         int64_t str0 = strings_a[i];
         for (size_t j = 0; j < norb; ++j) {
             bool sign_j = (str0 >> j) & 1;
-            auto this_row = sign_j ? mat_exp_ab_conj.row(static_cast<Index>(j))
-                                   : mat_exp.ab.row(static_cast<Index>(j));
+            const auto row = static_cast<Index>(j);
             for (size_t k = 0; k < norb; ++k) {
-                phase_map(static_cast<Index>(i), static_cast<Index>(k)) *=
-                    this_row(static_cast<Index>(k));
+                const auto col = static_cast<Index>(k);
+                phase_map(static_cast<Index>(i), col) *=
+                    sign_j ? mat_exp_ab_conj(row, col) : mat_exp.ab(row, col);
             }
 
             for (size_t k = j + 1; k < norb; ++k) {
@@ -380,6 +400,79 @@ VectorXcd apply_diag_coulomb_evolution(
     }
 }
 
+/**
+ * @brief Applies the same diagonal Coulomb evolution to many state vectors.
+ *
+ * The phase of every determinant is computed once and applied to all K
+ * states; the optional orbital rotations go through
+ * apply_orbital_rotation_batch_in_place, so their decompositions and index
+ * tables are also built once for the block.
+ *
+ * @param states dim x K matrix, one state vector per column
+ * @param mat The matrix representing the Coulomb interaction.
+ * @param time The time parameter for the evolution.
+ * @param norb The number of orbitals.
+ * @param nelec The number of electrons.
+ * @param orb_rot The optional orbital rotation to be applied.
+ * @param z_representation Flag indicating whether to use z-representation.
+ * @return The evolved states, dim x K
+ */
+MatrixXcd apply_diag_coulomb_evolution_batch(
+    const MatrixXcd &states, const Mat &mat, double time, uint64_t norb,
+    const Electron &nelec, const std::optional<OrbitalRotation> &orb_rot,
+    bool z_representation
+)
+{
+    std::pair<uint64_t, uint64_t> counts = nelec.spinfull;
+    if (nelec.type == ElectronType::Spinless) {
+        if (mat.type != MatType::Single || z_representation) {
+            throw std::runtime_error(
+                "Expected single matrix without z_representation for spinless "
+                "electron type"
+            );
+        }
+        counts = {nelec.spinless, 0};
+    }
+    const auto [n_alpha, n_beta] = counts;
+    const auto dim_a = static_cast<Index>(binomial(norb, n_alpha));
+    const auto dim_b = static_cast<Index>(binomial(norb, n_beta));
+    const Electron electron{ElectronType::Spinfull, 0, counts};
+
+    // Phases of all determinants, from the single-vector kernels on ones.
+    MatExp mat_exp = get_mat_exp(mat, norb, z_representation, time);
+    MatrixXcd phases = MatrixXcd::Ones(dim_a, dim_b);
+    std::vector<size_t> orb_list(norb);
+    std::iota(orb_list.begin(), orb_list.end(), 0);
+    if (z_representation) {
+        auto strings_a = make_strings(orb_list, n_alpha);
+        auto strings_b = make_strings(orb_list, n_beta);
+        apply_diag_coulomb_evolution_in_place_z_rep(
+            phases, norb, mat_exp, strings_a, strings_b
+        );
+    } else {
+        auto occupations_a = gen_occslst(orb_list, n_alpha);
+        auto occupations_b = gen_occslst(orb_list, n_beta);
+        apply_diag_coulomb_evolution_in_place_num_rep(
+            phases, norb, mat_exp, occupations_a, occupations_b
+        );
+    }
+
+    MatrixXcd transposed = states.transpose();
+    if (orb_rot.has_value()) {
+        apply_orbital_rotation_batch_in_place(
+            transposed, conjugate_orbital_rotation(orb_rot.value()), norb, electron
+        );
+    }
+    transposed.array().rowwise() *=
+        Map<const ArrayXcd>(phases.data(), dim_a * dim_b).transpose();
+    if (orb_rot.has_value()) {
+        apply_orbital_rotation_batch_in_place(
+            transposed, orb_rot.value(), norb, electron
+        );
+    }
+    return transposed.transpose();
+}
+
 } // namespace gates
 } // namespace ffsim
 
@@ -15,8 +15,10 @@
 #ifndef ORBITAL_ROTATION_HPP
 #define ORBITAL_ROTATION_HPP
 
+#include "ffsim/arena.hpp"
 #include "ffsim/gates/phase_shift.hpp"
 #include "ffsim/linalg/givens.hpp"
+#include "ffsim/linalg/matrix_utils.hpp"
 
 #include <Eigen/Dense>
 #include <complex>
@@ -110,48 +112,103 @@ std::vector<int64_t> make_strings(const std::vector<size_t> &orb_list, size_t ne
     return strings;
 }
 
-std::vector<size_t> zero_one_subspace_indices(
-    uint64_t norb, size_t nocc, const std::vector<size_t> &target_orbs
-)
+/**
+ * @brief Calls f(index, string) for every occupation string of nocc electrons
+ * in norb < 64 orbitals, in ascending order.
+ *
+ * Strings are enumerated in place with Gosper's hack, so no string list is
+ * materialized.
+ */
+template <typename F>
+void for_each_string(uint64_t norb, size_t nocc, F &&f)
 {
-    std::vector<size_t> orbitals = shifted_orbitals(norb, target_orbs);
-    std::vector<int64_t> strings = make_strings(orbitals, nocc);
+    if (nocc > norb) {
+        return;
+    }
+    if (nocc == 0) {
+        f(size_t(0), uint64_t(0));
+        return;
+    }
+    const uint64_t end = 1ULL << norb;
+    uint64_t string = (1ULL << nocc) - 1;
+    for (size_t index = 0; string < end; ++index) {
+        f(index, string);
+        uint64_t lowest = string & (~string + 1);
+        uint64_t ripple = string + lowest;
+        string = ripple | (((string ^ ripple) >> 2) / lowest);
+    }
+}
 
-    std::vector<size_t> indices(strings.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::sort(indices.begin(), indices.end(), [&](size_t i, size_t j) {
-        return strings[i] < strings[j];
+/**
+ * @brief Writes the indices of the strings with exactly one of two orbitals
+ * occupied.
+ *
+ * slice1 receives the strings with orbital first occupied and slice2 those with
+ * orbital second occupied, each C(norb - 2, nocc - 1) long and in ascending
+ * order, so that slice1[k] and slice2[k] agree on all other orbitals.
+ */
+void zero_one_subspace_slices(
+    uint64_t norb, size_t nocc, size_t first, size_t second, size_t *slice1,
+    size_t *slice2
+)
+{
+    const uint64_t mask_1 = 1ULL << first;
+    const uint64_t mask_2 = 1ULL << second;
+    for_each_string(norb, nocc, [&](size_t index, uint64_t string) {
+        bool occ_1 = string & mask_1;
+        bool occ_2 = string & mask_2;
+        if (occ_1 && !occ_2) {
+            *slice1++ = index;
+        } else if (occ_2 && !occ_1) {
+            *slice2++ = index;
+        }
     });
+}
 
-    size_t n00 = binomial(norb - 2, nocc);
-    size_t n11 = (nocc >= 2) ? binomial(norb - 2, nocc - 2) : 0;
+/**
+ * @brief Writes the indices of the strings with all target orbitals occupied,
+ * in ascending order.
+ * @return Number of indices written, C(norb - |targets|, nocc - |targets|)
+ */
+size_t one_subspace_slice(
+    uint64_t norb, size_t nocc, const std::vector<size_t> &target_orbs, size_t *slice
+)
+{
+    uint64_t mask = 0;
+    for (auto orb : target_orbs) {
+        mask |= 1ULL << orb;
+    }
+    size_t count = 0;
+    for_each_string(norb, nocc, [&](size_t index, uint64_t string) {
+        if ((string & mask) == mask) {
+            slice[count++] = index;
+        }
+    });
+    return count;
+}
 
-    return std::vector<size_t>(
-        indices.begin() + static_cast<std::ptrdiff_t>(n00),
-        indices.end() - static_cast<std::ptrdiff_t>(n11)
+std::vector<size_t> zero_one_subspace_indices(
+    uint64_t norb, size_t nocc, const std::vector<size_t> &target_orbs
+)
+{
+    size_t half = (nocc >= 1 && norb >= 2) ? binomial(norb - 2, nocc - 1) : 0;
+    std::vector<size_t> indices(2 * half);
+    zero_one_subspace_slices(
+        norb, nocc, target_orbs[0], target_orbs[1], indices.data(),
+        indices.data() + half
     );
+    return indices;
 }
 
 std::vector<size_t>
 one_subspace_indices(uint64_t norb, size_t nocc, const std::vector<size_t> &target_orbs)
 {
-    std::vector<size_t> orbitals = shifted_orbitals(norb, target_orbs);
-    std::vector<int64_t> strings = make_strings(orbitals, nocc);
-
-    std::vector<size_t> indices(strings.size());
-    std::iota(indices.begin(), indices.end(), 0);
-    std::sort(indices.begin(), indices.end(), [&](size_t i, size_t j) {
-        return strings[i] < strings[j];
-    });
-
-    size_t n0 = binomial(norb, nocc);
-    if (nocc >= target_orbs.size()) {
-        n0 -= binomial(norb - target_orbs.size(), nocc - target_orbs.size());
-    }
-
-    return std::vector<size_t>(
-        indices.begin() + static_cast<std::ptrdiff_t>(n0), indices.end()
-    );
+    size_t count = (nocc >= target_orbs.size())
+                       ? binomial(norb - target_orbs.size(), nocc - target_orbs.size())
+                       : 0;
+    std::vector<size_t> indices(count);
+    one_subspace_slice(norb, nocc, target_orbs, indices.data());
+    return indices;
 }
 
 /**
@@ -221,9 +278,15 @@ get_givens_decomposition(const OrbitalRotation &mat)
     }
 }
 
+/**
+ * @brief Applies a Givens rotation to pairs of rows of a reshaped state vector.
+ *
+ * Rows slice1[k] and slice2[k] are rotated through two contiguous row buffers
+ * taken once per call from the scratch arena.
+ */
 void apply_givens_rotation_in_place(
-    MatrixXcd &vec, double c, Complex s, const std::vector<size_t> &slice1,
-    const std::vector<size_t> &slice2
+    MatrixXcd &vec, double c, Complex s, const size_t *slice1, const size_t *slice2,
+    size_t size
 )
 {
     auto dim_b = vec.cols();
@@ -232,11 +295,14 @@ void apply_givens_rotation_in_place(
     Complex phase(std::cos(angle), std::sin(angle));
     Complex phase_conj = std::conj(phase);
 
-    for (size_t k = 0; k < slice1.size(); ++k) {
-        size_t i = slice1[k];
-        size_t j = slice2[k];
-        VectorXcd row_i = vec.row(static_cast<Eigen::Index>(i));
-        VectorXcd row_j = vec.row(static_cast<Eigen::Index>(j));
+    ArenaScope scope;
+    Map<VectorXcd> row_i(scope.allocate<Complex>(static_cast<size_t>(dim_b)), dim_b);
+    Map<VectorXcd> row_j(scope.allocate<Complex>(static_cast<size_t>(dim_b)), dim_b);
+    for (size_t k = 0; k < size; ++k) {
+        const auto i = static_cast<Eigen::Index>(slice1[k]);
+        const auto j = static_cast<Eigen::Index>(slice2[k]);
+        row_i = vec.row(i);
+        row_j = vec.row(j);
 
         // altanative method: zscal -> zdrot -> zscal
         row_i *= phase_conj;
@@ -248,11 +314,21 @@ void apply_givens_rotation_in_place(
         }
 
         row_i *= phase;
-        vec.row(static_cast<Eigen::Index>(i)) = row_i;
-        vec.row(static_cast<Eigen::Index>(j)) = row_j;
+        vec.row(i) = row_i;
+        vec.row(j) = row_j;
     }
 }
 
+void apply_givens_rotation_in_place(
+    MatrixXcd &vec, double c, Complex s, const std::vector<size_t> &slice1,
+    const std::vector<size_t> &slice2
+)
+{
+    apply_givens_rotation_in_place(
+        vec, c, s, slice1.data(), slice2.data(), slice1.size()
+    );
+}
+
 void apply_orbital_rotation_adjacent_spin_inplace(
     MatrixXcd &vec, double c, Complex s,
     const std::pair<uint64_t, uint64_t> &target_orbs, uint64_t norb, size_t nelec
@@ -262,39 +338,284 @@ void apply_orbital_rotation_adjacent_spin_inplace(
     size_t j = target_orbs.second;
     assert((i == j + 1 || i == j - 1) && "Target orbitals must be adjacent.");
 
-    std::vector<size_t> indices = one_subspace_indices(norb, nelec, {i, j});
-    size_t half = indices.size() / 2;
-    std::vector<size_t> silce1(
-        indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(half)
-    );
-    std::vector<size_t> slice2(
-        indices.begin() + static_cast<std::ptrdiff_t>(half), indices.end()
-    );
-    apply_givens_rotation_in_place(vec, c, s, silce1, slice2);
+    ArenaScope scope;
+    size_t half = (nelec >= 1 && norb >= 2) ? binomial(norb - 2, nelec - 1) : 0;
+    size_t *slice1 = scope.allocate<size_t>(half);
+    size_t *slice2 = scope.allocate<size_t>(half);
+    zero_one_subspace_slices(norb, nelec, i, j, slice1, slice2);
+    apply_givens_rotation_in_place(vec, c, s, slice1, slice2, half);
 }
 
-VectorXcd apply_orbital_rotation_spinless(
-    VectorXcd &vec, const MatrixXcd &mat, uint64_t norb, size_t nelec
+/**
+ * @brief Multiplies the rows of the strings with orbital orb occupied by phase.
+ */
+void apply_orbital_phase_shift_in_place(
+    MatrixXcd &vec, const Complex &phase, uint64_t norb, size_t nelec, size_t orb
 )
 {
-    auto [rotations, phase_shifts] = linalg::givens_decomposition(mat);
-    MatrixXcd reshaped = vec;
-    reshaped.resize(vec.size(), 1);
+    ArenaScope scope;
+    size_t *indices = scope.allocate<size_t>(static_cast<size_t>(vec.rows()));
+    size_t count = one_subspace_slice(norb, nelec, {orb}, indices);
+    apply_phase_shift_in_place(vec, phase, indices, count);
+}
+
+/**
+ * @brief Index of an occupation string among the strings with the same number
+ * of electrons in ascending order (its colexicographic rank).
+ */
+size_t string_index(uint64_t string)
+{
+    size_t index = 0;
+    size_t k = 1;
+    for (uint64_t p = 0; string != 0; ++p, string >>= 1) {
+        if (string & 1ULL) {
+            index += binomial(p, k++);
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief Matrix of an orbital rotation on the strings of nelec electrons.
+ *
+ * Entry (I, J) is the minor det(mat[I, J]) on the occupied orbitals of strings
+ * I and J, so that applying the rotation to the rows of a reshaped state is one
+ * product with this matrix. The minors of size k are expanded along their
+ * highest row into those of size k - 1, for O(C(norb, k)^2 k) work per size.
+ *
+ * @param mat norb x norb orbital rotation
+ * @param norb Number of spatial orbitals
+ * @param nelec Number of electrons in the rotated spin sector
+ * @return C(norb, nelec) x C(norb, nelec) matrix
+ */
+MatrixXcd string_space_rotation(const MatrixXcd &mat, uint64_t norb, size_t nelec)
+{
+    MatrixXcd minors = MatrixXcd::Ones(1, 1);
+    for (size_t k = 1; k <= nelec; ++k) {
+        const size_t dim = binomial(norb, k);
+        std::vector<uint64_t> strings(dim);
+        for_each_string(norb, k, [&](size_t index, uint64_t string) {
+            strings[index] = string;
+        });
+        // For each string, its orbitals from the highest down and the indices of
+        // the strings with one of them removed.
+        std::vector<Index> orbitals(dim * k);
+        std::vector<Index> without(dim * k);
+        for (size_t s = 0; s < dim; ++s) {
+            size_t m = 0;
+            for (uint64_t p = norb; p-- > 0;) {
+                if ((strings[s] >> p) & 1ULL) {
+                    orbitals[s * k + m] = static_cast<Index>(p);
+                    without[s * k + m] =
+                        static_cast<Index>(string_index(strings[s] ^ (1ULL << p)));
+                    ++m;
+                }
+            }
+        }
+
+        MatrixXcd next(static_cast<Index>(dim), static_cast<Index>(dim));
+#pragma omp parallel for schedule(static)
+        for (int64_t row = 0; row < static_cast<int64_t>(dim); ++row) {
+            const Index top = orbitals[row * k];
+            const Index rest = without[row * k];
+            for (size_t col = 0; col < dim; ++col) {
+                Complex sum = 0.0;
+                double sign = 1.0;
+                for (size_t m = 0; m < k; ++m) {
+                    sum += sign * mat(top, orbitals[col * k + m]) *
+                           minors(rest, without[col * k + m]);
+                    sign = -sign;
+                }
+                next(static_cast<Index>(row), static_cast<Index>(col)) = sum;
+            }
+        }
+        minors.swap(next);
+    }
+    return minors;
+}
+
+/// Largest string space rotated as one dense matrix: 2048^2 complex doubles
+/// are 64 MiB, and C(norb, nelec) stays below it up to norb = 13.
+constexpr size_t string_space_max_dim = 2048;
+
+/// Time of one ZGEMM complex multiply-add relative to one element update of a
+/// Givens rotation. Both were timed per element on random rotations with
+/// OpenBLAS 0.3.21 on one thread, for norb 8 to 12, nelec norb / 2 - 1 and
+/// norb / 2, and C(norb, norb / 2) columns: the ratio was 0.013 to 0.045 for
+/// dim >= 200, where the choice matters, and 0.1 for dim below 100.
+constexpr double string_space_gemm_weight = 0.03;
+
+/// The same ratio against apply_givens_rotation_batch_in_place with 16 states,
+/// timed the same way: 0.03 to 0.06 for dim >= 200.
+constexpr double string_space_batch_gemm_weight = 0.05;
+
+/**
+ * @brief Number of Givens rotations of a decomposition into the given diagonal
+ * blocks, n_k (n_k - 1) / 2 per block of n_k orbitals.
+ *
+ * This is the count of linalg::block_givens_decomposition before rotations of
+ * entries that are already zero are skipped, known without decomposing.
+ */
+size_t givens_rotation_count(const std::vector<std::vector<size_t>> &blocks)
+{
+    size_t count = 0;
+    for (const auto &block : blocks) {
+        count += block.size() * (block.size() - 1) / 2;
+    }
+    return count;
+}
+
+/**
+ * @brief Whether an orbital rotation is cheaper as one string-space product
+ * (string_space_rotation and ZGEMM) than as its Givens rotations.
+ *
+ * The Givens sequence rotates 2 C(norb - 2, nelec - 1) rows per rotation at a
+ * few flops per element and is bound by memory bandwidth; the product costs
+ * dim^2 multiply-adds per column at close to peak flops. Building the matrix
+ * is counted unless it is cached.
+ *
+ * @param norb Number of spatial orbitals
+ * @param nelec Number of electrons in the rotated spin sector
+ * @param cols Number of columns of the reshaped state
+ * @param n_givens Number of Givens rotations of the decomposition
+ * @param cached Whether the string-space matrix is already built
+ * @param gemm_weight Relative cost of a ZGEMM multiply-add
+ */
+bool prefer_string_space_rotation(
+    uint64_t norb, size_t nelec, size_t cols, size_t n_givens, bool cached,
+    double gemm_weight = string_space_gemm_weight
+)
+{
+    const size_t dim = binomial(norb, nelec);
+    if (dim < 2 || dim > string_space_max_dim || nelec == 0) {
+        return false;
+    }
+    const size_t half = norb >= 2 ? binomial(norb - 2, nelec - 1) : 0;
+    const double givens = 2.0 * static_cast<double>(n_givens * half * cols);
+    double gemm = gemm_weight * static_cast<double>(dim) *
+                  static_cast<double>(dim) * static_cast<double>(cols);
+    if (!cached) {
+        for (size_t k = 1; k <= nelec; ++k) {
+            const auto size = static_cast<double>(binomial(norb, k));
+            gemm += gemm_weight * size * size * static_cast<double>(k);
+        }
+    }
+    return gemm < givens;
+}
+
+/**
+ * @brief Applies a string-space rotation to the rows of vec with ZGEMM.
+ */
+void apply_string_space_rotation_in_place(MatrixXcd &vec, const MatrixXcd &rotation)
+{
+    MatrixXcd result(rotation.rows(), vec.cols());
+    linalg::zgemm(rotation, vec, result);
+    vec.swap(result);
+}
+
+/**
+ * @brief Negates the rows of the strings with an odd number of occupied
+ * crossing pairs.
+ *
+ * This maps the state between the canonical fermionic order and the block
+ * order of a linalg::BlockGivensDecomposition, and is its own inverse.
+ */
+void apply_crossing_signs_in_place(
+    MatrixXcd &vec, const std::vector<std::pair<size_t, size_t>> &crossings,
+    uint64_t norb, size_t nelec
+)
+{
+    if (crossings.empty()) {
+        return;
+    }
+    std::vector<uint64_t> masks(norb, 0);
+    for (const auto &[p, q] : crossings) {
+        masks[p] |= 1ULL << q;
+    }
+    for_each_string(norb, nelec, [&](size_t index, uint64_t string) {
+        uint64_t pairs = 0;
+        for (uint64_t p = 0; p < norb; ++p) {
+            if ((string >> p) & 1ULL) {
+                pairs ^= string & masks[p];
+            }
+        }
+        bool odd = false;
+        for (; pairs != 0; pairs &= pairs - 1) {
+            odd = !odd;
+        }
+        if (odd) {
+            vec.row(static_cast<Index>(index)) *= -1.0;
+        }
+    });
+}
 
-    for (const auto &rotation : rotations) {
-        apply_orbital_rotation_adjacent_spin_inplace(
-            reshaped, rotation.c, std::conj(rotation.s),
-            std::make_pair(rotation.i, rotation.j), norb, nelec
+/**
+ * @brief Applies the orbital rotation of one spin sector to the rows of vec.
+ *
+ * A block-diagonal matrix, e.g. one that conserves point-group symmetry, is
+ * decomposed one block at a time. The rotations then act in the block order,
+ * entered and left through apply_crossing_signs_in_place, on orbitals that
+ * need not be adjacent in the canonical order. Small string spaces take the
+ * ZGEMM path instead when prefer_string_space_rotation says so.
+ */
+void apply_orbital_rotation_spin_in_place(
+    MatrixXcd &vec, const MatrixXcd &mat, uint64_t norb, size_t nelec
+)
+{
+    auto blocks = linalg::detect_orbital_blocks(mat);
+    if (prefer_string_space_rotation(
+            norb, nelec, static_cast<size_t>(vec.cols()), givens_rotation_count(blocks),
+            false
+        )) {
+        apply_string_space_rotation_in_place(
+            vec, string_space_rotation(mat, norb, nelec)
         );
+        return;
     }
 
-    for (size_t i = 0; i < phase_shifts.size(); ++i) {
-        auto indices = one_subspace_indices(norb, nelec, {i});
-        apply_phase_shift_in_place(
-            reshaped, phase_shifts(static_cast<Eigen::Index>(i)), indices
+    if (blocks.size() == 1) {
+        auto [rotations, phase_shifts] = linalg::givens_decomposition(mat);
+        for (const auto &rotation : rotations) {
+            apply_orbital_rotation_adjacent_spin_inplace(
+                vec, rotation.c, std::conj(rotation.s),
+                std::make_pair(rotation.i, rotation.j), norb, nelec
+            );
+        }
+        for (size_t i = 0; i < phase_shifts.size(); ++i) {
+            apply_orbital_phase_shift_in_place(
+                vec, phase_shifts(static_cast<Eigen::Index>(i)), norb, nelec, i
+            );
+        }
+        return;
+    }
+
+    auto decomp = linalg::block_givens_decomposition(mat, blocks);
+    apply_crossing_signs_in_place(vec, decomp.crossings, norb, nelec);
+    size_t half = (nelec >= 1 && norb >= 2) ? binomial(norb - 2, nelec - 1) : 0;
+    for (const auto &rotation : decomp.rotations) {
+        ArenaScope scope;
+        size_t *slice1 = scope.allocate<size_t>(half);
+        size_t *slice2 = scope.allocate<size_t>(half);
+        zero_one_subspace_slices(norb, nelec, rotation.i, rotation.j, slice1, slice2);
+        apply_givens_rotation_in_place(
+            vec, rotation.c, std::conj(rotation.s), slice1, slice2, half
+        );
+    }
+    for (size_t i = 0; i < decomp.phase_shifts.size(); ++i) {
+        apply_orbital_phase_shift_in_place(
+            vec, decomp.phase_shifts(static_cast<Eigen::Index>(i)), norb, nelec, i
         );
     }
+    apply_crossing_signs_in_place(vec, decomp.crossings, norb, nelec);
+}
 
+VectorXcd apply_orbital_rotation_spinless(
+    VectorXcd &vec, const MatrixXcd &mat, uint64_t norb, size_t nelec
+)
+{
+    MatrixXcd reshaped = vec;
+    reshaped.resize(vec.size(), 1);
+    apply_orbital_rotation_spin_in_place(reshaped, mat, norb, nelec);
     return Map<VectorXcd>(reshaped.data(), vec.size());
 }
 
@@ -312,42 +633,12 @@ VectorXcd apply_orbital_rotation_spinfull(
     MatrixXcd reshaped = vec;
     reshaped.resize(static_cast<Eigen::Index>(dim_a), static_cast<Eigen::Index>(dim_b));
 
-    OrbitalRotation rot;
-    rot.type = OrbitalRotationType::Spinfull;
-    rot.spinfull = mat;
-
-    auto [decomp_a, decomp_b] = get_givens_decomposition(rot);
-
-    if (decomp_a) {
-        auto &[rots_a, phase_shifts_a] = *decomp_a;
-        for (const auto &rotation : rots_a) {
-            apply_orbital_rotation_adjacent_spin_inplace(
-                reshaped, rotation.c, std::conj(rotation.s),
-                std::make_pair(rotation.i, rotation.j), norb, n_alpha
-            );
-        }
-        for (size_t i = 0; i < phase_shifts_a.size(); ++i) {
-            auto indices = one_subspace_indices(norb, n_alpha, {i});
-            apply_phase_shift_in_place(
-                reshaped, phase_shifts_a(static_cast<Eigen::Index>(i)), indices
-            );
-        }
+    if (mat[0].has_value()) {
+        apply_orbital_rotation_spin_in_place(reshaped, *mat[0], norb, n_alpha);
     }
-    if (decomp_b) {
+    if (mat[1].has_value()) {
         MatrixXcd transposed = reshaped.transpose();
-        auto &[rots_b, phase_shifts_b] = *decomp_b;
-        for (const auto &rotation : rots_b) {
-            apply_orbital_rotation_adjacent_spin_inplace(
-                transposed, rotation.c, std::conj(rotation.s),
-                std::make_pair(rotation.i, rotation.j), norb, n_beta
-            );
-        }
-        for (size_t i = 0; i < phase_shifts_b.size(); ++i) {
-            auto indices = one_subspace_indices(norb, n_beta, {i});
-            apply_phase_shift_in_place(
-                transposed, phase_shifts_b(static_cast<Eigen::Index>(i)), indices
-            );
-        }
+        apply_orbital_rotation_spin_in_place(transposed, *mat[1], norb, n_beta);
         reshaped = transposed.transpose();
     }
     return Map<VectorXcd>(reshaped.data(), vec.size());
@@ -380,6 +671,10 @@ VectorXcd apply_orbital_rotation(
         return apply_orbital_rotation_spinless(
             vec, rotation.spinless, norb, nelec.spinless
         );
+    } else if (rotation.type == OrbitalRotationType::Spinless) {
+        return apply_orbital_rotation_spinfull(
+            vec, {rotation.spinless, rotation.spinless}, norb, nelec.spinfull
+        );
     } else {
         return apply_orbital_rotation_spinfull(
             vec, rotation.spinfull, norb, nelec.spinfull
@@ -387,6 +682,225 @@ VectorXcd apply_orbital_rotation(
     }
 }
 
+/**
+ * @brief Position of one spin sector's strings in a flattened state: string x
+ * with the other sector's string o sits at x * pair_stride + o * other_stride.
+ */
+struct SectorLayout {
+    size_t pair_stride;
+    size_t other_stride;
+    size_t n_other;
+};
+
+/**
+ * @brief Applies a Givens rotation to a block of states stored one per row
+ * (K x dim).
+ *
+ * Strings slice1[k] and slice2[k] of the rotated sector are combined for every
+ * string of the other sector, each update sweeping the K contiguous amplitudes
+ * of a column.
+ */
+void apply_givens_rotation_batch_in_place(
+    MatrixXcd &states, double c, Complex s, const size_t *slice1, const size_t *slice2,
+    size_t size, const SectorLayout &layout
+)
+{
+    const Index k_states = states.rows();
+    const Complex s_conj = std::conj(s);
+#pragma omp parallel for schedule(static)
+    for (int64_t o = 0; o < static_cast<int64_t>(layout.n_other); ++o) {
+        const size_t offset = static_cast<size_t>(o) * layout.other_stride;
+        for (size_t k = 0; k < size; ++k) {
+            const size_t col_x = slice1[k] * layout.pair_stride + offset;
+            const size_t col_y = slice2[k] * layout.pair_stride + offset;
+            Complex *x = states.col(static_cast<Index>(col_x)).data();
+            Complex *y = states.col(static_cast<Index>(col_y)).data();
+            for (Index r = 0; r < k_states; ++r) {
+                const Complex xr = x[r];
+                const Complex yr = y[r];
+                x[r] = c * xr + s * yr;
+                y[r] = c * yr - s_conj * xr;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Multiplies the columns of the given strings of one sector by phase,
+ * for every string of the other sector.
+ */
+void apply_phase_batch_in_place(
+    MatrixXcd &states, const Complex &phase, const size_t *indices, size_t count,
+    const SectorLayout &layout
+)
+{
+#pragma omp parallel for schedule(static)
+    for (int64_t o = 0; o < static_cast<int64_t>(layout.n_other); ++o) {
+        const size_t offset = static_cast<size_t>(o) * layout.other_stride;
+        for (size_t k = 0; k < count; ++k) {
+            states.col(static_cast<Index>(indices[k] * layout.pair_stride + offset)) *=
+                phase;
+        }
+    }
+}
+
+/**
+ * @brief Applies a string-space rotation to one sector of a block of states
+ * stored one per row, as ZGEMMs with the transposed rotation.
+ *
+ * Beta strings (other_stride 1) are the slow index, so the block is a single
+ * (K n_other) x dim product; alpha strings are the fast index and take one
+ * K x dim product per beta string.
+ */
+void apply_string_space_rotation_batch_in_place(
+    MatrixXcd &states, const MatrixXcd &rotation, const SectorLayout &layout
+)
+{
+    const Index k_states = states.rows();
+    const Index dim = rotation.rows();
+    if (layout.other_stride == 1 && layout.n_other > 1) {
+        Map<MatrixXcd> view(
+            states.data(), k_states * static_cast<Index>(layout.n_other), dim
+        );
+        MatrixXcd result(view.rows(), dim);
+        linalg::zgemm(view, rotation, result, true);
+        view = result;
+        return;
+    }
+    MatrixXcd result(k_states, dim);
+    for (size_t o = 0; o < layout.n_other; ++o) {
+        Map<MatrixXcd> block(
+            states.data() + static_cast<Index>(o * layout.other_stride) * k_states,
+            k_states, dim
+        );
+        linalg::zgemm(block, rotation, result, true);
+        block = result;
+    }
+}
+
+/**
+ * @brief Applies the orbital rotation of one spin sector to a block of states
+ * stored one per row.
+ *
+ * The decomposition, the subspace slices and the block-order signs are built
+ * once and each gate is then swept across all states. Small string spaces go
+ * through ZGEMM instead when prefer_string_space_rotation says so.
+ */
+void apply_orbital_rotation_sector_batch_in_place(
+    MatrixXcd &states, const MatrixXcd &mat, uint64_t norb, size_t nelec,
+    const SectorLayout &layout
+)
+{
+    auto blocks = linalg::detect_orbital_blocks(mat);
+    const size_t dim = binomial(norb, nelec);
+    const auto columns = static_cast<size_t>(states.rows()) * layout.n_other;
+    if (prefer_string_space_rotation(
+            norb, nelec, columns, givens_rotation_count(blocks), false,
+            string_space_batch_gemm_weight
+        )) {
+        apply_string_space_rotation_batch_in_place(
+            states, string_space_rotation(mat, norb, nelec), layout
+        );
+        return;
+    }
+    auto decomp = linalg::block_givens_decomposition(mat, blocks);
+
+    // Strings that change sign between the canonical and the block order.
+    std::vector<size_t> odd;
+    if (!decomp.crossings.empty()) {
+        MatrixXcd signs = MatrixXcd::Ones(static_cast<Index>(dim), 1);
+        apply_crossing_signs_in_place(signs, decomp.crossings, norb, nelec);
+        for (size_t x = 0; x < dim; ++x) {
+            if (signs(static_cast<Index>(x), 0).real() < 0.0) {
+                odd.push_back(x);
+            }
+        }
+    }
+    apply_phase_batch_in_place(states, -1.0, odd.data(), odd.size(), layout);
+
+    ArenaScope scope;
+    size_t half = (nelec >= 1 && norb >= 2) ? binomial(norb - 2, nelec - 1) : 0;
+    size_t *slice1 = scope.allocate<size_t>(half);
+    size_t *slice2 = scope.allocate<size_t>(half);
+    for (const auto &rotation : decomp.rotations) {
+        zero_one_subspace_slices(norb, nelec, rotation.i, rotation.j, slice1, slice2);
+        apply_givens_rotation_batch_in_place(
+            states, rotation.c, std::conj(rotation.s), slice1, slice2, half, layout
+        );
+    }
+    size_t *indices = scope.allocate<size_t>(dim);
+    for (size_t i = 0; i < decomp.phase_shifts.size(); ++i) {
+        size_t count = one_subspace_slice(norb, nelec, {i}, indices);
+        apply_phase_batch_in_place(
+            states, decomp.phase_shifts(static_cast<Index>(i)), indices, count, layout
+        );
+    }
+
+    apply_phase_batch_in_place(states, -1.0, odd.data(), odd.size(), layout);
+}
+
+/**
+ * @brief Applies an orbital rotation to a block of states stored one per row
+ * (K x dim), the layout used by the batch gates.
+ */
+void apply_orbital_rotation_batch_in_place(
+    MatrixXcd &states, const OrbitalRotation &rotation, uint64_t norb,
+    const Electron &nelec
+)
+{
+    if (nelec.type == ElectronType::Spinless) {
+        if (rotation.type != OrbitalRotationType::Spinless) {
+            throw std::runtime_error(
+                "Expected spinless orbital rotation with spinless electron type"
+            );
+        }
+        apply_orbital_rotation_sector_batch_in_place(
+            states, rotation.spinless, norb, nelec.spinless, {1, 0, 1}
+        );
+        return;
+    }
+    const auto [n_alpha, n_beta] = nelec.spinfull;
+    const size_t dim_a = binomial(norb, n_alpha);
+    const size_t dim_b = binomial(norb, n_beta);
+    std::array<std::optional<MatrixXcd>, 2> mats = rotation.spinfull;
+    if (rotation.type == OrbitalRotationType::Spinless) {
+        mats = {rotation.spinless, rotation.spinless};
+    }
+    if (mats[0].has_value()) {
+        apply_orbital_rotation_sector_batch_in_place(
+            states, *mats[0], norb, n_alpha, {1, dim_a, dim_b}
+        );
+    }
+    if (mats[1].has_value()) {
+        apply_orbital_rotation_sector_batch_in_place(
+            states, *mats[1], norb, n_beta, {dim_a, 1, dim_a}
+        );
+    }
+}
+
+/**
+ * @brief Applies the same orbital rotation to many state vectors.
+ *
+ * The Givens decomposition and the index tables are computed once for the whole
+ * block, and every rotation runs over all K states in its inner loop. Compared
+ * with K calls of apply_orbital_rotation this pays off from about K = 8.
+ *
+ * @param states dim x K matrix, one state vector per column
+ * @param rotation Orbital rotation specification
+ * @param norb Number of orbitals
+ * @param nelec Electron occupation info
+ * @return The rotated states, dim x K
+ */
+MatrixXcd apply_orbital_rotation_batch(
+    const MatrixXcd &states, const OrbitalRotation &rotation, uint64_t norb,
+    const Electron &nelec
+)
+{
+    MatrixXcd transposed = states.transpose();
+    apply_orbital_rotation_batch_in_place(transposed, rotation, norb, nelec);
+    return transposed.transpose();
+}
+
 /**
  * @brief Generates all possible occupation lists.
  *
@@ -428,8 +942,12 @@ gen_occslst(const std::vector<size_t> &orb_list, size_t nelec)
         }
     };
 
+    // Order the lists like their bit strings, i.e. by the highest orbital first,
+    // so that they line up with the state vector indices.
     auto res = gen_occs_iter(orb_list, nelec);
-    std::sort(res.begin(), res.end());
+    std::sort(res.begin(), res.end(), [](const auto &a, const auto &b) {
+        return std::lexicographical_compare(a.rbegin(), a.rend(), b.rbegin(), b.rend());
+    });
     return res;
 }
 
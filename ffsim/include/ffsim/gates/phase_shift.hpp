@@ -17,6 +17,7 @@
 
 #include <Eigen/Dense>
 #include <complex>
+#include <vector>
 
 namespace ffsim
 {
@@ -31,16 +32,24 @@ using Complex = std::complex<double>;
  * @param phase The phase shift to be applied.
  * @param indices The indices of the rows/columns to which the phase shift is
  * applied.
+ * @param size The number of indices.
  */
 void apply_phase_shift_in_place(
-    MatrixXcd &mat, const Complex &phase, const std::vector<size_t> &indices
+    MatrixXcd &mat, const Complex &phase, const size_t *indices, size_t size
 )
 {
-    for (size_t row : indices) {
-        mat.row(static_cast<Index>(row)) *= phase;
+    for (size_t k = 0; k < size; ++k) {
+        mat.row(static_cast<Index>(indices[k])) *= phase;
     }
 }
 
+void apply_phase_shift_in_place(
+    MatrixXcd &mat, const Complex &phase, const std::vector<size_t> &indices
+)
+{
+    apply_phase_shift_in_place(mat, phase, indices.data(), indices.size());
+}
+
 } // namespace gates
 } // namespace ffsim
 #endif // PHASE_SHIFT_HPP
\ No newline at end of file
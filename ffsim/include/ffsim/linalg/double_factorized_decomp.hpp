@@ -17,6 +17,7 @@
 
 #include <Eigen/Dense>
 #include <complex>
+#include <functional>
 #include <optional>
 #include <tuple>
 #include <unsupported/Eigen/CXX11/Tensor>
@@ -223,6 +224,150 @@ std::tuple<Tensor<Complex, 4>, Tensor<Complex, 4>> double_factorized_t2(
     return {diag_coulomb_out, orbital_rotations};
 }
 
+/**
+ * @brief Computes a pivoted (modified) Cholesky decomposition of a positive
+ * semidefinite matrix given only its diagonal and on-demand columns.
+ *
+ * The matrix M is approximated as L L^T, where L has one column per Cholesky
+ * vector. At each step the column with the largest residual diagonal is chosen
+ * as pivot, and the decomposition stops once the largest residual diagonal
+ * falls below `tol`. Only the diagonal and the pivot columns of M are ever
+ * requested, so M never needs to be stored.
+ *
+ * @param diagonal The diagonal of M (length `dim`)
+ * @param column Callback returning column j of M (length `dim`)
+ * @param tol Tolerance on the largest residual diagonal element
+ * @param max_vecs Optional limit on the number of Cholesky vectors
+ * @return The Cholesky vectors as the columns of a `dim x n_vecs` matrix
+ */
+MatrixXd modified_cholesky(
+    const VectorXd &diagonal, const std::function<VectorXd(Index)> &column, double tol,
+    std::optional<size_t> max_vecs
+)
+{
+    const Index dim = diagonal.size();
+    const Index limit = max_vecs.has_value()
+                            ? std::min<Index>(dim, static_cast<Index>(*max_vecs))
+                            : dim;
+
+    // The number of vectors is usually a small multiple of sqrt(dim), far below
+    // the limit, so the columns are allocated as they are needed.
+    MatrixXd vecs(dim, std::min<Index>(limit, 16));
+    VectorXd residual = diagonal;
+    Index n_vecs = 0;
+    while (n_vecs < limit) {
+        Index pivot;
+        double max_residual = residual.maxCoeff(&pivot);
+        if (max_residual <= tol) {
+            break;
+        }
+        if (n_vecs == vecs.cols()) {
+            vecs.conservativeResize(NoChange, std::min(limit, 2 * n_vecs));
+        }
+        VectorXd vec = column(pivot);
+        vec.noalias() -=
+            vecs.leftCols(n_vecs) * vecs.row(pivot).head(n_vecs).transpose();
+        vec /= std::sqrt(max_residual);
+        residual -= vec.cwiseAbs2();
+        vecs.col(n_vecs++) = vec;
+    }
+    return vecs.leftCols(n_vecs);
+}
+
+/**
+ * @brief Computes a pivoted (modified) Cholesky decomposition of a dense
+ * positive semidefinite matrix.
+ *
+ * @param mat The matrix to decompose
+ * @param tol Tolerance on the largest residual diagonal element
+ * @param max_vecs Optional limit on the number of Cholesky vectors
+ * @return The Cholesky vectors as the columns of a `dim x n_vecs` matrix
+ */
+MatrixXd
+modified_cholesky(const MatrixXd &mat, double tol, std::optional<size_t> max_vecs)
+{
+    return modified_cholesky(
+        mat.diagonal(), [&](Index j) -> VectorXd { return mat.col(j); }, tol, max_vecs
+    );
+}
+
+/**
+ * @brief Computes low-rank Cholesky vectors of the two-electron integrals.
+ *
+ * The integrals (pq|rs) are approximated as sum_k L^k_pq L^k_rs with each L^k a
+ * real symmetric `norb x norb` matrix. The decomposition works on the
+ * npair x npair supermatrix over symmetric orbital pairs, reading columns
+ * directly from the packed storage, so the memory cost is O(norb^2 * n_vecs)
+ * on top of the input.
+ *
+ * @param eri The two-electron integrals packed as in FCIDump::eri
+ * @param norb The number of spatial orbitals
+ * @param tol Tolerance on the largest residual diagonal integral (pq|pq)
+ * @param max_vecs Optional limit on the number of Cholesky vectors
+ * @return The Cholesky vectors L^k
+ */
+std::vector<MatrixXd> cholesky_eri(
+    const std::vector<double> &eri, size_t norb, double tol,
+    std::optional<size_t> max_vecs
+)
+{
+    auto packed = [](size_t i, size_t j) {
+        return (i >= j) ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i;
+    };
+    const auto npair = static_cast<Index>(norb * (norb + 1) / 2);
+
+    VectorXd diagonal(npair);
+    for (Index i = 0; i < npair; ++i) {
+        diagonal(i) = eri[packed(i, i)];
+    }
+    auto column = [&](Index j) -> VectorXd {
+        VectorXd col(npair);
+        for (Index i = 0; i < npair; ++i) {
+            col(i) = eri[packed(i, j)];
+        }
+        return col;
+    };
+    MatrixXd vecs = modified_cholesky(diagonal, column, tol, max_vecs);
+
+    const auto n = static_cast<Index>(norb);
+    std::vector<MatrixXd> cholesky_vecs(vecs.cols(), MatrixXd(n, n));
+    for (Index k = 0; k < vecs.cols(); ++k) {
+        for (Index p = 0; p < n; ++p) {
+            for (Index q = 0; q <= p; ++q) {
+                double value = vecs(p * (p + 1) / 2 + q, k);
+                cholesky_vecs[k](p, q) = value;
+                cholesky_vecs[k](q, p) = value;
+            }
+        }
+    }
+    return cholesky_vecs;
+}
+
+/**
+ * @brief Computes the double factorization of Cholesky vectors.
+ *
+ * Each symmetric Cholesky vector is diagonalized as L^k = U_k diag(lambda_k)
+ * U_k^T, so that (pq|rs) = sum_k sum_ij U^k_pi U^k_qi lambda^k_i lambda^k_j
+ * U^k_rj U^k_sj.
+ *
+ * @param cholesky_vecs The Cholesky vectors, e.g. from cholesky_eri
+ * @return A tuple of (eigenvalues, orbital_rotations), one entry per vector
+ */
+std::tuple<std::vector<VectorXd>, std::vector<MatrixXd>>
+double_factorized(const std::vector<MatrixXd> &cholesky_vecs)
+{
+    std::vector<VectorXd> eigs;
+    std::vector<MatrixXd> orbital_rotations;
+    eigs.reserve(cholesky_vecs.size());
+    orbital_rotations.reserve(cholesky_vecs.size());
+    for (const auto &vec : cholesky_vecs) {
+        SelfAdjointEigenSolver<MatrixXd> es(vec);
+        eigs.push_back(es.eigenvalues());
+        orbital_rotations.push_back(es.eigenvectors());
+    }
+    return {eigs, orbital_rotations};
+}
+
 } // namespace linalg
 } // namespace ffsim
 
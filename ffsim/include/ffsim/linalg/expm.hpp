@@ -32,6 +32,26 @@ MatrixXcd expm(const MatrixXcd &A)
 {
     return A.exp();
 }
+
+/**
+ * @brief Computes the Frechet derivative of the matrix exponential.
+ *
+ * L(A, E) = d/dt expm(A + t E) at t = 0, read off the upper right block of
+ * expm([[A, E], [0, A]]).
+ *
+ * @param A The point at which the derivative is taken.
+ * @param E The direction of the derivative.
+ * @return The Frechet derivative L(A, E).
+ */
+MatrixXcd expm_frechet(const MatrixXcd &A, const MatrixXcd &E)
+{
+    const Index n = A.rows();
+    MatrixXcd block = MatrixXcd::Zero(2 * n, 2 * n);
+    block.topLeftCorner(n, n) = A;
+    block.topRightCorner(n, n) = E;
+    block.bottomRightCorner(n, n) = A;
+    return expm(block).topRightCorner(n, n);
+}
 } // namespace linalg
 } // namespace ffsim
 #endif // EXPM_HPP
\ No newline at end of file
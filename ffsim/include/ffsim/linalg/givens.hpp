@@ -16,8 +16,12 @@
 #define GIVENS_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cassert>
 #include <complex>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace ffsim
@@ -209,6 +213,163 @@ givens_decomposition(const MatrixXcd &mat)
     return {right_rotations, current_matrix.diagonal()};
 }
 
+/**
+ * @brief Givens decomposition of a block-diagonal matrix, one block at a time.
+ *
+ * The blocks are laid out one after the other in `order`. Rotations act on
+ * orbitals that are adjacent in that order, which are adjacent in the
+ * Jordan-Wigner sense once the fermionic modes are reordered to `order`. The
+ * reordering is a sign on each occupation string: -1 for every pair in
+ * `crossings` that is occupied.
+ */
+struct BlockGivensDecomposition {
+    std::vector<size_t> order;             ///< Orbitals block by block
+    std::vector<GivensRotation> rotations; ///< Indices are orbitals
+    VectorXcd phase_shifts;                ///< Final phase of each orbital
+    /// Orbital pairs (p < q) with q ahead of p in `order`
+    std::vector<std::pair<size_t, size_t>> crossings;
+};
+
+/**
+ * @brief Finds the diagonal blocks of a matrix, the connected components of
+ * its nonzero pattern.
+ *
+ * @param mat A square matrix
+ * @param atol Entries up to this magnitude count as zero
+ * @return Blocks as ascending orbital lists, ordered by their first orbital
+ */
+std::vector<std::vector<size_t>>
+detect_orbital_blocks(const MatrixXcd &mat, double atol = 1e-12)
+{
+    const auto n = static_cast<size_t>(mat.rows());
+    std::vector<size_t> root(n);
+    std::iota(root.begin(), root.end(), 0);
+    auto find = [&](size_t p) {
+        while (root[p] != p) {
+            p = root[p] = root[root[p]];
+        }
+        return p;
+    };
+    for (Index i = 0; i < mat.rows(); ++i) {
+        for (Index j = i + 1; j < mat.cols(); ++j) {
+            if (std::abs(mat(i, j)) > atol || std::abs(mat(j, i)) > atol) {
+                size_t a = find(static_cast<size_t>(i));
+                size_t b = find(static_cast<size_t>(j));
+                root[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+    std::vector<std::vector<size_t>> blocks;
+    std::vector<size_t> block_of(n);
+    for (size_t p = 0; p < n; ++p) {
+        size_t r = find(p);
+        if (r == p) {
+            block_of[p] = blocks.size();
+            blocks.emplace_back();
+        }
+        blocks[block_of[r]].push_back(p);
+    }
+    return blocks;
+}
+
+/**
+ * @brief Groups orbitals by point-group irrep, e.g. the FCIDUMP ORBSYM labels.
+ *
+ * @param orbsym Irrep label of each orbital
+ * @return Blocks as ascending orbital lists, ordered by their first orbital
+ */
+std::vector<std::vector<size_t>> irrep_blocks(const std::vector<int> &orbsym)
+{
+    std::vector<int> labels;
+    std::vector<std::vector<size_t>> blocks;
+    for (size_t p = 0; p < orbsym.size(); ++p) {
+        auto it = std::find(labels.begin(), labels.end(), orbsym[p]);
+        if (it == labels.end()) {
+            labels.push_back(orbsym[p]);
+            blocks.emplace_back();
+            it = labels.end() - 1;
+        }
+        blocks[static_cast<size_t>(it - labels.begin())].push_back(p);
+    }
+    return blocks;
+}
+
+/**
+ * @brief Decomposes a block-diagonal unitary into Givens rotations, one
+ * diagonal block at a time.
+ *
+ * A block of size n_k costs n_k (n_k - 1) / 2 rotations, instead of the
+ * n (n - 1) / 2 of the full matrix.
+ *
+ * @param mat A square unitary matrix, zero outside the blocks
+ * @param blocks Partition of the orbitals, e.g. from detect_orbital_blocks()
+ * or irrep_blocks()
+ * @param atol Largest magnitude allowed outside the blocks
+ * @return Rotations and phases in the block order
+ * @throws std::invalid_argument if mat couples two blocks
+ */
+BlockGivensDecomposition block_givens_decomposition(
+    const MatrixXcd &mat, const std::vector<std::vector<size_t>> &blocks,
+    double atol = 1e-12
+)
+{
+    const auto n = static_cast<size_t>(mat.rows());
+    BlockGivensDecomposition decomp;
+    std::vector<size_t> block_of(n, blocks.size());
+    std::vector<size_t> position(n);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        for (auto p : blocks[b]) {
+            if (p >= n || block_of[p] != blocks.size()) {
+                throw std::invalid_argument("blocks must partition the orbitals");
+            }
+            block_of[p] = b;
+            position[p] = decomp.order.size();
+            decomp.order.push_back(p);
+        }
+    }
+    if (decomp.order.size() != n) {
+        throw std::invalid_argument("blocks must partition the orbitals");
+    }
+    for (size_t p = 0; p < n; ++p) {
+        for (size_t q = 0; q < n; ++q) {
+            if (block_of[p] != block_of[q] &&
+                std::abs(mat(static_cast<Index>(p), static_cast<Index>(q))) > atol) {
+                throw std::invalid_argument(
+                    "orbital rotation couples orbitals of different blocks"
+                );
+            }
+        }
+        for (size_t q = p + 1; q < n; ++q) {
+            if (position[q] < position[p]) {
+                decomp.crossings.emplace_back(p, q);
+            }
+        }
+    }
+
+    decomp.phase_shifts = VectorXcd::Ones(static_cast<Index>(n));
+    for (const auto &block : blocks) {
+        const auto size = static_cast<Index>(block.size());
+        MatrixXcd sub(size, size);
+        for (Index i = 0; i < size; ++i) {
+            for (Index j = 0; j < size; ++j) {
+                sub(i, j) = mat(
+                    static_cast<Index>(block[static_cast<size_t>(i)]),
+                    static_cast<Index>(block[static_cast<size_t>(j)])
+                );
+            }
+        }
+        auto [rotations, phases] = givens_decomposition(sub);
+        for (const auto &rot : rotations) {
+            decomp.rotations.emplace_back(rot.c, rot.s, block[rot.i], block[rot.j]);
+        }
+        for (Index i = 0; i < size; ++i) {
+            decomp.phase_shifts(static_cast<Index>(block[static_cast<size_t>(i)])) =
+                phases(i);
+        }
+    }
+    return decomp;
+}
+
 } // namespace linalg
 } // namespace ffsim
 
@@ -2,6 +2,7 @@
 #define MATRIX_UTILS_HPP
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cmath>
 #include <complex>
 
@@ -11,6 +12,45 @@ namespace linalg
 {
 using namespace Eigen;
 using Complex = std::complex<double>;
+
+extern "C" {
+void zgemm_(
+    const char *transa, const char *transb, const int *m, const int *n, const int *k,
+    const Complex *alpha, const Complex *a, const int *lda, const Complex *b,
+    const int *ldb, const Complex *beta, Complex *c, const int *ldc
+);
+}
+
+/**
+ * @brief Computes c = a * b, or c = a * b^T, with the BLAS ZGEMM.
+ *
+ * @param a Left factor
+ * @param b Right factor
+ * @param c Product, already of size a.rows() x (columns of b or b^T)
+ * @param transpose_b Whether to multiply by the transpose of b
+ */
+inline void zgemm(
+    const Ref<const MatrixXcd> &a, const Ref<const MatrixXcd> &b, Ref<MatrixXcd> c,
+    bool transpose_b = false
+)
+{
+    const int m = static_cast<int>(c.rows());
+    const int n = static_cast<int>(c.cols());
+    const int k = static_cast<int>(a.cols());
+    if (m == 0 || n == 0) {
+        return;
+    }
+    const Complex one(1.0, 0.0);
+    const Complex zero(0.0, 0.0);
+    const int lda = std::max<int>(1, static_cast<int>(a.outerStride()));
+    const int ldb = std::max<int>(1, static_cast<int>(b.outerStride()));
+    const int ldc = std::max<int>(1, static_cast<int>(c.outerStride()));
+    zgemm_(
+        "N", transpose_b ? "T" : "N", &m, &n, &k, &one, a.data(), &lda, b.data(), &ldb,
+        &zero, c.data(), &ldc
+    );
+}
+
 inline bool array_all_close(
     const MatrixXcd &mat1, const MatrixXcd &mat2, double rtol = 1e-5, double atol = 1e-8
 )
@@ -0,0 +1,295 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef MOLECULAR_HAMILTONIAN_HPP
+#define MOLECULAR_HAMILTONIAN_HPP
+
+#include "ffsim/fcidump.hpp"
+#include "gates/orbital_rotation.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+using Complex = std::complex<double>;
+
+/**
+ * @brief Single excitation of an occupation string.
+ *
+ * An entry stored for string I with orbital pair p * norb + q states that
+ * <I| a^dagger_p a_q |J> = sign, i.e. a^dagger_q a_p |I> = sign |J>.
+ */
+struct SingleExcitation {
+    Index target;          ///< Index of the string J
+    uint32_t orbital_pair; ///< p * norb + q
+    double sign;           ///< Fermionic sign, +1 or -1
+};
+
+/**
+ * @brief Builds the table of all single excitations of every occupation string.
+ *
+ * Each string has nelec * (norb - nelec + 1) entries, including the nelec
+ * diagonal ones with p = q, stored contiguously in string order.
+ *
+ * @param norb Number of spatial orbitals
+ * @param nelec Number of electrons in the spin sector
+ * @return The flattened excitation table
+ */
+std::vector<SingleExcitation> single_excitation_table(uint64_t norb, size_t nelec)
+{
+    if (norb >= 64) {
+        throw std::invalid_argument("single_excitation_table requires norb < 64");
+    }
+    std::vector<size_t> orb_list(norb);
+    std::iota(orb_list.begin(), orb_list.end(), 0);
+    auto strings = make_strings(orb_list, nelec);
+    const size_t stride = nelec * (norb - nelec + 1);
+    std::vector<SingleExcitation> table(strings.size() * stride);
+
+#pragma omp parallel for schedule(static)
+    for (size_t s = 0; s < strings.size(); ++s) {
+        auto string = static_cast<uint64_t>(strings[s]);
+        size_t k = s * stride;
+        for (uint64_t p = 0; p < norb; ++p) {
+            if (!((string >> p) & 1ULL)) {
+                continue;
+            }
+            for (uint64_t q = 0; q < norb; ++q) {
+                if (q != p && ((string >> q) & 1ULL)) {
+                    continue;
+                }
+                // The sign counts the occupied orbitals strictly between p and q.
+                uint64_t lo = std::min(p, q);
+                uint64_t hi = std::max(p, q);
+                uint64_t between = string & ((1ULL << hi) - 1) & ~((2ULL << lo) - 1);
+                uint64_t target = string ^ (1ULL << p) ^ (1ULL << q);
+                table[k++] = {
+                    static_cast<Index>(string_index(target)),
+                    static_cast<uint32_t>(p * norb + q),
+                    std::bitset<64>(between).count() % 2 ? -1.0 : 1.0
+                };
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Matrix-free molecular Hamiltonian on the spinful Fock space sector
+ * with fixed (alpha, beta) electron counts.
+ *
+ * H = sum_pq k_pq E_pq + 1/2 sum_pqrs (pq|rs) E_pq E_rs + constant with
+ * E_pq = sum_sigma a^dagger_{p,sigma} a_{q,sigma} and
+ * k_pq = h_pq - 1/2 sum_r (pr|rq). States are vectors of dimension
+ * C(norb, n_alpha) * C(norb, n_beta) with the alpha string index running
+ * fastest, as in the rest of ffsim.
+ *
+ * The product H|c> gathers D_pq = E_pq |c> for a block of determinants from
+ * the single-excitation tables, contracts the integrals with GEMMs and scatters
+ * the result back through the same tables. The blocks hold at most
+ * density_block_bytes of D, so memory stays O(dim) whatever the size of the
+ * active space. The two-body integrals are kept as their norb^2 x L Cholesky
+ * vectors when the FCIDUMP is factorized and as a dense norb^2 x norb^2 matrix
+ * otherwise.
+ */
+class MolecularHamiltonian
+{
+  public:
+    /**
+     * @brief Builds the operator from FCIDUMP integrals.
+     * @param fcidump Molecular integrals, packed or factorized
+     * @param nelec (alpha, beta) electron counts, by default taken from NELEC
+     * and MS2
+     */
+    MolecularHamiltonian(
+        const FCIDump &fcidump,
+        std::optional<std::pair<uint64_t, uint64_t>> nelec = std::nullopt
+    )
+      : norb_(fcidump.norb), nelec_(nelec.value_or(fcidump.nelec_pair())),
+        constant_(fcidump.constant)
+    {
+        const auto n = static_cast<Index>(norb_);
+        one_body_.resize(n * n);
+        for (Index p = 0; p < n; ++p) {
+            for (Index q = 0; q < n; ++q) {
+                double value = fcidump.one_body(p, q);
+                for (Index r = 0; r < n; ++r) {
+                    value -= 0.5 * fcidump.two_body(p, r, r, q);
+                }
+                one_body_(p * n + q) = value;
+            }
+        }
+        if (fcidump.eri.empty()) {
+            // 1/2 (pq|rs) = sum_k M^k_pq M^k_rs with M^k = L^k / sqrt(2).
+            const auto num_vecs = static_cast<Index>(fcidump.cholesky_vecs.size());
+            cholesky_.resize(n * n, num_vecs);
+            for (Index k = 0; k < num_vecs; ++k) {
+                const MatrixXd &vec = fcidump.cholesky_vecs[k];
+                for (Index pq = 0; pq < n * n; ++pq) {
+                    cholesky_(pq, k) = vec(pq / n, pq % n) / std::sqrt(2.0);
+                }
+            }
+        } else {
+            two_body_.resize(n * n, n * n);
+#pragma omp parallel for schedule(dynamic)
+            for (Index pq = 0; pq < n * n; ++pq) {
+                for (Index rs = 0; rs < n * n; ++rs) {
+                    two_body_(rs, pq) =
+                        0.5 * fcidump.two_body(pq / n, pq % n, rs / n, rs % n);
+                }
+            }
+        }
+        table_a_ = single_excitation_table(norb_, nelec_.first);
+        table_b_ = nelec_.second == nelec_.first
+                       ? table_a_
+                       : single_excitation_table(norb_, nelec_.second);
+        dim_a_ = static_cast<Index>(binomial(norb_, nelec_.first));
+        dim_b_ = static_cast<Index>(binomial(norb_, nelec_.second));
+    }
+
+    /**
+     * @brief Returns the dimension of the state vectors.
+     */
+    Index dim() const
+    {
+        return dim_a_ * dim_b_;
+    }
+
+    /**
+     * @brief Applies the Hamiltonian to a state vector.
+     * @param vec State vector of dimension dim()
+     * @return H |vec>
+     */
+    VectorXcd apply(const VectorXcd &vec) const
+    {
+        if (vec.size() != dim()) {
+            throw std::invalid_argument("State vector has the wrong dimension");
+        }
+        const auto n2 = static_cast<Index>(norb_ * norb_);
+        const size_t stride_a = nelec_.first * (norb_ - nelec_.first + 1);
+        const size_t stride_b = nelec_.second * (norb_ - nelec_.second + 1);
+        const Index block_size = std::max<Index>(
+            1, static_cast<Index>(density_block_bytes / (n2 * sizeof(Complex)))
+        );
+
+        VectorXcd result = constant_ * vec;
+        auto *out = reinterpret_cast<double *>(result.data());
+        MatrixXcd density;
+        MatrixXcd contracted;
+        for (Index begin = 0; begin < dim(); begin += block_size) {
+            const Index size = std::min(block_size, dim() - begin);
+
+            // density(pq, J - begin) = <J| E_pq |vec>
+            density.setZero(n2, size);
+#pragma omp parallel for schedule(static)
+            for (Index j = 0; j < size; ++j) {
+                const Index det = begin + j;
+                const Index ia = det % dim_a_;
+                const Index ib = det / dim_a_;
+                for (size_t k = ia * stride_a; k < (ia + 1) * stride_a; ++k) {
+                    const auto &e = table_a_[k];
+                    density(e.orbital_pair, j) += e.sign * vec(e.target + dim_a_ * ib);
+                }
+                for (size_t k = ib * stride_b; k < (ib + 1) * stride_b; ++k) {
+                    const auto &e = table_b_[k];
+                    density(e.orbital_pair, j) += e.sign * vec(ia + dim_a_ * e.target);
+                }
+            }
+
+            result.segment(begin, size).noalias() +=
+                density.transpose() * one_body_.cast<Complex>();
+            if (cholesky_.size() > 0) {
+                MatrixXcd projected = cholesky_.transpose().cast<Complex>() * density;
+                contracted.noalias() = cholesky_.cast<Complex>() * projected;
+            } else {
+                contracted.noalias() = two_body_.cast<Complex>() * density;
+            }
+
+            // H|vec> picks up <I| E_pq |J> contracted(pq, J) = <J| E_qp |I>
+            // contracted(pq, J) for every I connected to J; the integrals are
+            // symmetric in p and q, so the entries of J's own table scatter it.
+#pragma omp parallel for schedule(static)
+            for (Index j = 0; j < size; ++j) {
+                const Index det = begin + j;
+                const Index ia = det % dim_a_;
+                const Index ib = det / dim_a_;
+                for (size_t k = ia * stride_a; k < (ia + 1) * stride_a; ++k) {
+                    const auto &e = table_a_[k];
+                    scatter(
+                        out, e.target + dim_a_ * ib,
+                        e.sign * contracted(e.orbital_pair, j)
+                    );
+                }
+                for (size_t k = ib * stride_b; k < (ib + 1) * stride_b; ++k) {
+                    const auto &e = table_b_[k];
+                    scatter(
+                        out, ia + dim_a_ * e.target,
+                        e.sign * contracted(e.orbital_pair, j)
+                    );
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the energy expectation value <vec|H|vec> / <vec|vec>.
+     * @param vec State vector of dimension dim()
+     * @return The energy, including the constant term
+     */
+    double energy(const VectorXcd &vec) const
+    {
+        return vec.dot(apply(vec)).real() / vec.squaredNorm();
+    }
+
+  private:
+    /// Bound on the memory of one block of the one-body density in apply().
+    static constexpr size_t density_block_bytes = size_t(64) << 20;
+
+    // Adds value to the complex entry index of the array out from several
+    // threads at once.
+    static void scatter(double *out, Index index, Complex value)
+    {
+#pragma omp atomic
+        out[2 * index] += value.real();
+#pragma omp atomic
+        out[2 * index + 1] += value.imag();
+    }
+
+    uint64_t norb_;
+    std::pair<uint64_t, uint64_t> nelec_;
+    double constant_;
+    Index dim_a_;
+    Index dim_b_;
+    VectorXd one_body_; ///< k_pq at index p * norb + q
+    MatrixXd two_body_; ///< 1/2 (pq|rs) at (rs, pq), empty if factorized
+    MatrixXd cholesky_; ///< L^k_pq / sqrt(2) at (pq, k), empty if not factorized
+    std::vector<SingleExcitation> table_a_;
+    std::vector<SingleExcitation> table_b_;
+};
+
+} // namespace ffsim
+
+#endif // MOLECULAR_HAMILTONIAN_HPP
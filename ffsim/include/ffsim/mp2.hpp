@@ -0,0 +1,189 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef MP2_HPP
+#define MP2_HPP
+
+#include "ffsim/fcidump.hpp"
+#include <Eigen/Dense>
+#include <complex>
+#include <stdexcept>
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using Complex = std::complex<double>;
+
+/**
+ * @brief Closed-shell MP2 amplitudes and derived quantities.
+ *
+ * The amplitudes follow the conventions of `UCJOpSpinBalanced::from_t_amplitudes`:
+ * t2 has shape `[nocc, nocc, nvrt, nvrt]` and t1 has shape `[nocc, nvrt]`.
+ */
+struct MP2Result {
+    Tensor<Complex, 4> t2;        ///< t2_ijab = (ia|jb) / (e_i + e_j - e_a - e_b)
+    MatrixXcd t1;                 ///< t1_ia = f_ia / (e_i - e_a)
+    VectorXd orbital_energies;    ///< Diagonal of the Fock matrix
+    double energy = 0.0;          ///< MP2 correlation energy
+    MatrixXd rdm1;                ///< Unrelaxed spin-summed one-body density
+    VectorXd natural_occupations; ///< Eigenvalues of rdm1, in descending order
+};
+
+/**
+ * @brief Computes the closed-shell Fock matrix of the lowest nocc orbitals.
+ *
+ * f_pq = h_pq + sum_i [2 (pq|ii) - (pi|iq)].
+ *
+ * @param fcidump Molecular integrals
+ * @param nocc Number of doubly occupied orbitals
+ * @return The `norb x norb` Fock matrix
+ */
+MatrixXd fock_matrix(const FCIDump &fcidump, size_t nocc)
+{
+    const auto n = static_cast<Index>(fcidump.norb);
+    MatrixXd fock = fcidump.one_body;
+#pragma omp parallel for schedule(dynamic)
+    for (Index p = 0; p < n; ++p) {
+        for (Index q = 0; q <= p; ++q) {
+            double value = 0.0;
+            for (size_t i = 0; i < nocc; ++i) {
+                value += 2.0 * fcidump.two_body(p, q, i, i) -
+                         fcidump.two_body(p, i, i, q);
+            }
+            fock(p, q) += value;
+            if (q != p) {
+                fock(q, p) += value;
+            }
+        }
+    }
+    return fock;
+}
+
+/**
+ * @brief Computes closed-shell MP2 amplitudes from FCIDUMP integrals.
+ *
+ * Orbital energies are the diagonal of the Fock matrix built from the integrals,
+ * so non-canonical orbitals give first-order t1 amplitudes. The (ia|jb) block is
+ * formed one occupied orbital at a time: with factorized integrals as the GEMM
+ * B_i^T B over Cholesky vectors B^k_jb = L^k_jb, otherwise gathered from the
+ * packed integrals. Blocks are processed in parallel with OpenMP.
+ *
+ * @param fcidump Molecular integrals, optionally factorized
+ * @return The MP2 amplitudes, correlation energy and one-body density
+ * @throws std::invalid_argument for open-shell systems
+ */
+MP2Result mp2(const FCIDump &fcidump)
+{
+    auto [n_alpha, n_beta] = fcidump.nelec_pair();
+    if (n_alpha != n_beta) {
+        throw std::invalid_argument("MP2 is only implemented for closed shells");
+    }
+    const auto norb = static_cast<Index>(fcidump.norb);
+    const auto nocc = static_cast<Index>(n_alpha);
+    const Index nvrt = norb - nocc;
+    const Index n_ov = nocc * nvrt;
+
+    MP2Result result;
+    MatrixXd fock = fock_matrix(fcidump, nocc);
+    result.orbital_energies = fock.diagonal();
+    const VectorXd &e = result.orbital_energies;
+
+    result.t1.resize(nocc, nvrt);
+    for (Index i = 0; i < nocc; ++i) {
+        for (Index a = 0; a < nvrt; ++a) {
+            result.t1(i, a) = fock(i, nocc + a) / (e(i) - e(nocc + a));
+        }
+    }
+
+    // Cholesky vectors restricted to the occupied-virtual block, columns jb.
+    const bool factorized = fcidump.eri.empty();
+    MatrixXd chol_ov;
+    if (factorized) {
+        chol_ov.resize(static_cast<Index>(fcidump.cholesky_vecs.size()), n_ov);
+        for (Index k = 0; k < chol_ov.rows(); ++k) {
+            const auto &vec = fcidump.cholesky_vecs[k];
+            for (Index j = 0; j < nocc; ++j) {
+                chol_ov.row(k).segment(j * nvrt, nvrt) = vec.row(j).tail(nvrt);
+            }
+        }
+    }
+
+    result.t2.resize(nocc, nocc, nvrt, nvrt);
+    double energy = 0.0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : energy)
+    for (Index i = 0; i < nocc; ++i) {
+        // ovov(a, jb) = (ia|jb)
+        MatrixXd ovov(nvrt, n_ov);
+        if (factorized) {
+            ovov.noalias() = chol_ov.middleCols(i * nvrt, nvrt).transpose() * chol_ov;
+        } else {
+            for (Index a = 0; a < nvrt; ++a) {
+                for (Index j = 0; j < nocc; ++j) {
+                    for (Index b = 0; b < nvrt; ++b) {
+                        ovov(a, j * nvrt + b) =
+                            fcidump.two_body(i, nocc + a, j, nocc + b);
+                    }
+                }
+            }
+        }
+        for (Index j = 0; j < nocc; ++j) {
+            for (Index a = 0; a < nvrt; ++a) {
+                for (Index b = 0; b < nvrt; ++b) {
+                    double iajb = ovov(a, j * nvrt + b);
+                    double ibja = ovov(b, j * nvrt + a);
+                    double t = iajb / (e(i) + e(j) - e(nocc + a) - e(nocc + b));
+                    result.t2(i, j, a, b) = t;
+                    energy += t * (2.0 * iajb - ibja);
+                }
+            }
+        }
+    }
+    result.energy = energy;
+
+    // Unrelaxed density, D_ij = 2 delta_ij - 2 sum_kab t_ikab (2 t_jkab - t_jkba)
+    // and D_ab = 2 sum_ijc t_ijac (2 t_ijbc - t_ijcb).
+    result.rdm1 = MatrixXd::Zero(norb, norb);
+    MatrixXd t2_ij(nocc * nvrt, nvrt), t2_anti(nocc * nvrt, nvrt);
+    MatrixXd t2_i(nocc, nvrt * nvrt), t2_anti_i(nocc, nvrt * nvrt);
+    for (Index i = 0; i < nocc; ++i) {
+        for (Index j = 0; j < nocc; ++j) {
+            for (Index a = 0; a < nvrt; ++a) {
+                for (Index b = 0; b < nvrt; ++b) {
+                    double t = result.t2(i, j, a, b).real();
+                    double t_swap = result.t2(i, j, b, a).real();
+                    t2_ij(j * nvrt + a, b) = t;
+                    t2_anti(j * nvrt + a, b) = 2.0 * t - t_swap;
+                    t2_i(j, a * nvrt + b) = t;
+                    t2_anti_i(j, a * nvrt + b) = 2.0 * t - t_swap;
+                }
+            }
+        }
+        result.rdm1.bottomRightCorner(nvrt, nvrt).noalias() +=
+            2.0 * t2_ij.transpose() * t2_anti;
+        result.rdm1.topLeftCorner(nocc, nocc).noalias() -=
+            2.0 * t2_i * t2_anti_i.transpose();
+    }
+    result.rdm1.topLeftCorner(nocc, nocc).diagonal().array() += 2.0;
+
+    SelfAdjointEigenSolver<MatrixXd> es(result.rdm1, EigenvaluesOnly);
+    result.natural_occupations = es.eigenvalues().reverse();
+    return result;
+}
+
+} // namespace ffsim
+
+#endif // MP2_HPP
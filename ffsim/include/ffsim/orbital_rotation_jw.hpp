@@ -28,22 +28,13 @@ using namespace Eigen;
 using namespace gates;
 
 /**
- * @brief Applies an orbital rotation to a list of qubits.
- *
- * This is a helper function for performing an orbital rotation.
- *
- * @param qubits Qubit indices representing the orbital register
- * @param orbital_rotation Orbital rotation matrix
- * @return Vector of `CircuitInstruction` objects implementing the rotation
+ * @brief Appends the Givens rotations of a decomposition as XX+YY gates.
  */
-std::vector<CircuitInstruction> orbital_rotation_jw(
-    const std::vector<uint32_t> &qubits, const MatrixXcd &orbital_rotation
+void append_givens_jw(
+    std::vector<CircuitInstruction> &instructions, const std::vector<uint32_t> &qubits,
+    const std::vector<linalg::GivensRotation> &givens_rotations
 )
 {
-    auto [givens_rotations, phase_shifts] =
-        linalg::givens_decomposition(orbital_rotation);
-    std::vector<CircuitInstruction> instructions;
-
     for (const auto &rotation : givens_rotations) {
         double c = round_for_acos(rotation.c);
         double theta = 2.0 * std::acos(c);
@@ -56,7 +47,17 @@ std::vector<CircuitInstruction> orbital_rotation_jw(
              std::vector<double>{theta, beta}}
         );
     }
+}
 
+/**
+ * @brief Appends one RZ gate per orbital for the final phases of a
+ * decomposition.
+ */
+void append_phase_shifts_jw(
+    std::vector<CircuitInstruction> &instructions, const std::vector<uint32_t> &qubits,
+    const VectorXcd &phase_shifts
+)
+{
     for (size_t i = 0; i < phase_shifts.size(); ++i) {
         double theta = std::arg(phase_shifts(static_cast<Index>(i)));
         instructions.push_back(
@@ -66,7 +67,95 @@ std::vector<CircuitInstruction> orbital_rotation_jw(
              std::vector<double>{theta}}
         );
     }
+}
+
+/**
+ * @brief Appends a controlled-Z (CP(pi)) per crossing pair, the sign that
+ * switches between the canonical and the block fermionic order.
+ */
+void append_crossing_signs_jw(
+    std::vector<CircuitInstruction> &instructions, const std::vector<uint32_t> &qubits,
+    const std::vector<std::pair<size_t, size_t>> &crossings
+)
+{
+    for (const auto &[p, q] : crossings) {
+        instructions.push_back(
+            {"cp",
+             {static_cast<unsigned int>(qubits[p]),
+              static_cast<unsigned int>(qubits[q])},
+             {},
+             std::vector<double>{M_PI}}
+        );
+    }
+}
+
+/**
+ * @brief Estimates the nearest-neighbour two-qubit gate count of a block
+ * decomposition on a line of qubits in orbital order.
+ *
+ * A gate between orbitals p and q is counted as 2 |p - q| - 1 gates, itself
+ * plus the SWAPs that bring the qubits together and back.
+ */
+size_t routed_cost_jw(const linalg::BlockGivensDecomposition &decomp)
+{
+    auto cost = [](size_t p, size_t q) { return 2 * (p > q ? p - q : q - p) - 1; };
+    size_t total = 0;
+    for (const auto &rotation : decomp.rotations) {
+        total += cost(rotation.i, rotation.j);
+    }
+    for (const auto &[p, q] : decomp.crossings) {
+        total += 2 * cost(p, q);
+    }
+    return total;
+}
+
+/**
+ * @brief Applies an orbital rotation to a list of qubits.
+ *
+ * This is a helper function for performing an orbital rotation.
+ *
+ * A rotation that is block diagonal, either by the given irrep labels or by
+ * its own zero pattern, can be decomposed one block at a time: a block of n_k
+ * orbitals needs n_k (n_k - 1) / 2 XX+YY gates instead of n (n - 1) / 2 for
+ * the whole matrix. The blocks are made contiguous in the Jordan-Wigner order
+ * by CP(pi) gates on the pairs of orbitals whose order changes, emitted before
+ * and after the rotations, so the qubit layout stays the same. Blocks that
+ * are not contiguous in the qubit order make some of those gates long range,
+ * so the block decomposition is used only when its routed_cost_jw() is below
+ * the n (n - 1) / 2 nearest-neighbour gates of the dense one, which always
+ * holds for contiguous blocks.
+ *
+ * @param qubits Qubit indices representing the orbital register
+ * @param orbital_rotation Orbital rotation matrix
+ * @param orbsym Optional point-group irrep label of each orbital (FCIDUMP
+ * ORBSYM); the blocks are detected from the matrix if empty
+ * @return Vector of `CircuitInstruction` objects implementing the rotation
+ * @throws std::invalid_argument if orbital_rotation couples different irreps
+ */
+std::vector<CircuitInstruction> orbital_rotation_jw(
+    const std::vector<uint32_t> &qubits, const MatrixXcd &orbital_rotation,
+    const std::vector<int> &orbsym = {}
+)
+{
+    std::vector<CircuitInstruction> instructions;
+    auto blocks = orbsym.empty() ? linalg::detect_orbital_blocks(orbital_rotation)
+                                 : linalg::irrep_blocks(orbsym);
+    const auto n = static_cast<size_t>(orbital_rotation.rows());
+    if (blocks.size() > 1) {
+        auto decomp = linalg::block_givens_decomposition(orbital_rotation, blocks);
+        if (routed_cost_jw(decomp) < n * (n - 1) / 2) {
+            append_crossing_signs_jw(instructions, qubits, decomp.crossings);
+            append_givens_jw(instructions, qubits, decomp.rotations);
+            append_phase_shifts_jw(instructions, qubits, decomp.phase_shifts);
+            append_crossing_signs_jw(instructions, qubits, decomp.crossings);
+            return instructions;
+        }
+    }
 
+    auto [givens_rotations, phase_shifts] =
+        linalg::givens_decomposition(orbital_rotation);
+    append_givens_jw(instructions, qubits, givens_rotations);
+    append_phase_shifts_jw(instructions, qubits, phase_shifts);
     return instructions;
 }
 
@@ -87,14 +176,16 @@ class OrbitalRotationJW
      * @param validate Whether to validate unitarity of the rotation matrices
      * @param rtol Relative tolerance for validation
      * @param atol Absolute tolerance for validation
+     * @param orbsym Optional irrep label of each orbital, to decompose the
+     * rotation one irrep block at a time
      *
      * @throws std::runtime_error if validation fails
      */
     OrbitalRotationJW(
         uint64_t norb, const OrbitalRotation &orbital_rotation, bool validate = true,
-        double rtol = 1e-5, double atol = 1e-8
+        double rtol = 1e-5, double atol = 1e-8, std::vector<int> orbsym = {}
     )
-      : norb(norb)
+      : norb(norb), orbsym(std::move(orbsym))
     {
         if (validate) {
             validate_orbital_rotation(orbital_rotation, rtol, atol);
@@ -126,18 +217,21 @@ class OrbitalRotationJW
         std::vector<uint32_t> alpha_qubits(qubits.begin(), qubits.begin() + norb_tmp);
         std::vector<uint32_t> beta_qubits(qubits.begin() + norb_tmp, qubits.end());
 
-        auto instructions = orbital_rotation_jw(alpha_qubits, orbital_rotation_a);
-        auto beta_instructions = orbital_rotation_jw(beta_qubits, orbital_rotation_b);
-        instructions.insert(
-            instructions.end(), beta_instructions.begin(), beta_instructions.end()
-        );
-        return instructions;
+        // The alpha and beta decompositions are independent.
+        SegmentBuilder alpha = [&] {
+            return orbital_rotation_jw(alpha_qubits, orbital_rotation_a, orbsym);
+        };
+        SegmentBuilder beta = [&] {
+            return orbital_rotation_jw(beta_qubits, orbital_rotation_b, orbsym);
+        };
+        return build_segments_concurrently({alpha, beta});
     }
 
   private:
     uint64_t norb;                ///< Number of orbitals
     MatrixXcd orbital_rotation_a; ///< Orbital rotation matrix for alpha spin
     MatrixXcd orbital_rotation_b; ///< Orbital rotation matrix for beta spin
+    std::vector<int> orbsym;      ///< Irrep label of each orbital, may be empty
 };
 
 } // namespace ffsim
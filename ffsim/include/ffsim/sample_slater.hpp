@@ -0,0 +1,254 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef SAMPLE_SLATER_HPP
+#define SAMPLE_SLATER_HPP
+
+#include "gates/orbital_rotation.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+
+namespace detail
+{
+
+/// Shots drawn from one random stream, so results do not depend on the number
+/// of threads.
+constexpr Index slater_shots_per_stream = 1024;
+
+/**
+ * @brief Draws one set of occupied orbitals from the projection determinantal
+ * point process with kernel K = orbitals orbitals^dagger.
+ *
+ * Orbitals are picked one at a time with probability proportional to the
+ * diagonal of the kernel conditioned on the orbitals already picked. The
+ * conditioning is a Schur complement, applied lazily as an incremental
+ * Cholesky factor: step k costs O(norb * k), O(norb * nocc^2) per draw.
+ *
+ * @param kernel norb x norb kernel matrix
+ * @param nocc Number of occupied orbitals
+ * @param factor Work matrix of at least norb x nocc
+ * @param weights Work vector of norb conditional occupation probabilities
+ * @param gen Random number generator
+ * @param occupation Packed occupation bits, orbital p at bit p % 64 of word
+ * p / 64
+ */
+template <typename Generator>
+void sample_projection_dpp(
+    const MatrixXcd &kernel, Index nocc, MatrixXcd &factor, VectorXd &weights,
+    Generator &gen, uint64_t *occupation
+)
+{
+    const Index norb = kernel.rows();
+    weights = kernel.diagonal().real();
+    for (Index k = 0; k < nocc; ++k) {
+        double target =
+            std::uniform_real_distribution<double>(0.0, weights.sum())(gen);
+        // If rounding leaves target above the cumulative sum, the last orbital
+        // of positive weight is picked.
+        Index p = norb - 1;
+        for (Index q = 0; q < norb; ++q) {
+            if (weights(q) <= 0.0) {
+                continue;
+            }
+            p = q;
+            target -= weights(q);
+            if (target < 0.0) {
+                break;
+            }
+        }
+        occupation[p / 64] |= uint64_t(1) << (p % 64);
+        auto column = factor.col(k);
+        column = kernel.col(p);
+        column.noalias() -= factor.leftCols(k) * factor.row(p).head(k).adjoint();
+        column /= std::sqrt(weights(p));
+        weights = (weights - column.cwiseAbs2()).cwiseMax(0.0);
+        weights(p) = 0.0;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Samples the occupied orbitals of one spin sector of a Slater
+ * determinant, without forming the state vector.
+ *
+ * The cost is O(norb * nocc^2) per shot. Shots run in parallel; each block of
+ * detail::slater_shots_per_stream shots uses its own generator seeded from
+ * (seed, block), so the result only depends on the seed.
+ *
+ * @param orbitals norb x nocc matrix whose orthonormal columns are the occupied
+ * orbitals
+ * @param shots Number of samples
+ * @param seed Random seed
+ * @return Packed occupations, (norb + 63) / 64 words per shot
+ */
+std::vector<uint64_t>
+sample_slater_determinant_spin(const MatrixXcd &orbitals, size_t shots, uint64_t seed)
+{
+    const Index words = (orbitals.rows() + 63) / 64;
+    const Index nocc = orbitals.cols();
+    const MatrixXcd kernel = orbitals * orbitals.adjoint();
+    const auto n_shots = static_cast<Index>(shots);
+    const Index n_streams =
+        (n_shots + detail::slater_shots_per_stream - 1) /
+        detail::slater_shots_per_stream;
+    std::vector<uint64_t> occupations(shots * static_cast<size_t>(words), 0);
+#pragma omp parallel
+    {
+        MatrixXcd factor(orbitals.rows(), nocc);
+        VectorXd weights;
+#pragma omp for schedule(dynamic)
+        for (Index stream = 0; stream < n_streams; ++stream) {
+            std::seed_seq seq{
+                static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                static_cast<uint32_t>(stream)
+            };
+            std::mt19937_64 gen(seq);
+            Index end = std::min(
+                n_shots, (stream + 1) * detail::slater_shots_per_stream
+            );
+            for (Index shot = stream * detail::slater_shots_per_stream; shot < end;
+                 ++shot) {
+                detail::sample_projection_dpp(
+                    kernel, nocc, factor, weights, gen, &occupations[shot * words]
+                );
+            }
+        }
+    }
+    return occupations;
+}
+
+/**
+ * @brief Samples packed bitstrings from a Slater determinant, without forming
+ * the state vector.
+ *
+ * The state is the one prepared by PrepareSlaterDeterminantJW: occupied
+ * orbitals (columns) of the orbital rotation for each spin. Alpha and beta
+ * sectors are sampled independently.
+ *
+ * @param norb Number of spatial orbitals
+ * @param occupied_orbitals Occupied orbitals for (alpha, beta) electrons
+ * @param orbital_rotation Optional orbital rotation, identity if absent
+ * @param shots Number of samples
+ * @param seed Random seed
+ * @return (2 * norb + 63) / 64 words per shot, qubit q at bit q % 64 of word
+ * q / 64 (alpha orbitals on qubits 0..norb-1, beta on norb..2*norb-1)
+ */
+std::vector<uint64_t> sample_slater_determinant_packed(
+    uint64_t norb,
+    const std::pair<std::vector<uint64_t>, std::vector<uint64_t>> &occupied_orbitals,
+    const std::optional<OrbitalRotation> &orbital_rotation, size_t shots,
+    uint64_t seed
+)
+{
+    const auto n = static_cast<Index>(norb);
+    std::array<MatrixXcd, 2> rotations = {
+        MatrixXcd::Identity(n, n), MatrixXcd::Identity(n, n)
+    };
+    if (orbital_rotation.has_value()) {
+        if (orbital_rotation->type == OrbitalRotationType::Spinless) {
+            rotations = {orbital_rotation->spinless, orbital_rotation->spinless};
+        } else {
+            for (size_t spin = 0; spin < 2; ++spin) {
+                if (orbital_rotation->spinfull[spin].has_value()) {
+                    rotations[spin] = *orbital_rotation->spinfull[spin];
+                }
+            }
+        }
+    }
+    const std::array<const std::vector<uint64_t> *, 2> occupied = {
+        &occupied_orbitals.first, &occupied_orbitals.second
+    };
+    const size_t spin_words = (norb + 63) / 64;
+    const size_t words = (2 * norb + 63) / 64;
+    std::vector<uint64_t> packed(shots * words, 0);
+    for (size_t spin = 0; spin < 2; ++spin) {
+        if (rotations[spin].rows() != n || rotations[spin].cols() != n) {
+            throw std::invalid_argument("orbital rotation must be norb x norb");
+        }
+        MatrixXcd orbitals(n, static_cast<Index>(occupied[spin]->size()));
+        for (size_t j = 0; j < occupied[spin]->size(); ++j) {
+            orbitals.col(static_cast<Index>(j)) =
+                rotations[spin].col(static_cast<Index>((*occupied[spin])[j]));
+        }
+        auto occupations = sample_slater_determinant_spin(orbitals, shots, seed + spin);
+#pragma omp parallel for schedule(static)
+        for (int64_t shot = 0; shot < static_cast<int64_t>(shots); ++shot) {
+            const uint64_t *occupation = &occupations[shot * spin_words];
+            uint64_t *bits = &packed[shot * words];
+            for (uint64_t p = 0; p < norb; ++p) {
+                if ((occupation[p / 64] >> (p % 64)) & 1ULL) {
+                    uint64_t q = spin * norb + p;
+                    bits[q / 64] |= uint64_t(1) << (q % 64);
+                }
+            }
+        }
+    }
+    return packed;
+}
+
+/**
+ * @brief Samples bitstrings from a Slater determinant, without forming the
+ * state vector.
+ *
+ * @param norb Number of spatial orbitals
+ * @param occupied_orbitals Occupied orbitals for (alpha, beta) electrons
+ * @param orbital_rotation Optional orbital rotation, identity if absent
+ * @param shots Number of samples
+ * @param seed Random seed
+ * @return Bitstrings of 2 * norb characters in qubit order (alpha orbitals on
+ * qubits 0..norb-1, beta on norb..2*norb-1), qubit 0 the last character
+ */
+std::vector<std::string> sample_slater_determinant(
+    uint64_t norb,
+    const std::pair<std::vector<uint64_t>, std::vector<uint64_t>> &occupied_orbitals,
+    const std::optional<OrbitalRotation> &orbital_rotation, size_t shots,
+    uint64_t seed
+)
+{
+    const size_t words = (2 * norb + 63) / 64;
+    auto packed = sample_slater_determinant_packed(
+        norb, occupied_orbitals, orbital_rotation, shots, seed
+    );
+    std::vector<std::string> bitstrings(shots, std::string(2 * norb, '0'));
+#pragma omp parallel for schedule(static)
+    for (int64_t shot = 0; shot < static_cast<int64_t>(shots); ++shot) {
+        const uint64_t *bits = &packed[shot * words];
+        for (uint64_t q = 0; q < 2 * norb; ++q) {
+            if ((bits[q / 64] >> (q % 64)) & 1ULL) {
+                bitstrings[shot][2 * norb - 1 - q] = '1';
+            }
+        }
+    }
+    return bitstrings;
+}
+
+} // namespace ffsim
+
+#endif // SAMPLE_SLATER_HPP
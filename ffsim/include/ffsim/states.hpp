@@ -0,0 +1,124 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef STATES_HPP
+#define STATES_HPP
+
+#include "gates/orbital_rotation.hpp"
+#include <Eigen/Dense>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+
+/**
+ * @brief Returns the dimension of the spinful state vectors.
+ * @param norb Number of spatial orbitals
+ * @param nelec (alpha, beta) electron counts
+ * @return C(norb, n_alpha) * C(norb, n_beta)
+ */
+Index dim(uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec)
+{
+    return static_cast<Index>(binomial(norb, nelec.first)) *
+           static_cast<Index>(binomial(norb, nelec.second));
+}
+
+/**
+ * @brief Returns the Hartree-Fock state, with the lowest orbitals of each spin
+ * sector occupied.
+ * @param norb Number of spatial orbitals
+ * @param nelec (alpha, beta) electron counts
+ * @return The state vector
+ */
+VectorXcd hartree_fock_state(uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec)
+{
+    VectorXcd vec = VectorXcd::Zero(dim(norb, nelec));
+    vec(0) = 1.0;
+    return vec;
+}
+
+/**
+ * @brief Computes the spin-resolved orbital occupancies of a state vector.
+ *
+ * The probabilities |amplitude|^2 are first summed into marginal distributions
+ * over alpha and beta strings, column by column in parallel. The occupancy of
+ * orbital p is then the marginal probability summed over the strings with bit p
+ * set, a masked reduction over contiguous arrays that the compiler vectorizes.
+ *
+ * @param vec State vector, not necessarily normalized
+ * @param norb Number of spatial orbitals
+ * @param nelec (alpha, beta) electron counts
+ * @return Occupancies of orbitals 0, ..., norb - 1 for alpha and beta electrons
+ */
+std::array<std::vector<double>, 2> orbital_occupancies(
+    const VectorXcd &vec, uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec
+)
+{
+    const auto dim_a = static_cast<Index>(binomial(norb, nelec.first));
+    const auto dim_b = static_cast<Index>(binomial(norb, nelec.second));
+    if (vec.size() != dim_a * dim_b) {
+        throw std::invalid_argument("State vector has the wrong dimension");
+    }
+    Map<const MatrixXcd> reshaped(vec.data(), dim_a, dim_b);
+
+    VectorXd probs_a = VectorXd::Zero(dim_a);
+    VectorXd probs_b(dim_b);
+#pragma omp parallel
+    {
+        VectorXd local = VectorXd::Zero(dim_a);
+#pragma omp for schedule(static) nowait
+        for (Index j = 0; j < dim_b; ++j) {
+            VectorXd column = reshaped.col(j).cwiseAbs2();
+            local += column;
+            probs_b(j) = column.sum();
+        }
+#pragma omp critical
+        probs_a += local;
+    }
+    const double norm = probs_b.sum();
+
+    std::vector<size_t> orb_list(norb);
+    std::iota(orb_list.begin(), orb_list.end(), 0);
+    auto accumulate = [&](const VectorXd &probs, size_t n_elec) {
+        auto strings = make_strings(orb_list, n_elec);
+        const double *prob = probs.data();
+        const int64_t *string = strings.data();
+        const auto n_strings = static_cast<Index>(strings.size());
+        std::vector<double> occupancies(norb);
+#pragma omp parallel for schedule(static)
+        for (uint64_t p = 0; p < norb; ++p) {
+            const int64_t mask = int64_t(1) << p;
+            double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+            for (Index s = 0; s < n_strings; ++s) {
+                sum += (string[s] & mask) ? prob[s] : 0.0;
+            }
+            occupancies[p] = sum / norm;
+        }
+        return occupancies;
+    };
+    return {accumulate(probs_a, nelec.first), accumulate(probs_b, nelec.second)};
+}
+
+} // namespace ffsim
+
+#endif // STATES_HPP
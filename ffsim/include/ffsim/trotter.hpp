@@ -0,0 +1,379 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef TROTTER_HPP
+#define TROTTER_HPP
+
+#include "circuit_instruction.hpp"
+#include "diag_coulomb_jw.hpp"
+#include "double_factorized_hamiltonian.hpp"
+#include "ffsim/linalg/expm.hpp"
+#include "gates/diag_coulomb.hpp"
+#include "gates/orbital_rotation.hpp"
+#include "orbital_rotation_jw.hpp"
+#include <Eigen/Dense>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+
+/**
+ * @brief One Trotter step as alternating orbital rotations and diagonal
+ * Coulomb evolutions.
+ *
+ * The step applies rotations[0], diags[0], rotations[1], ..., diags[m-1],
+ * rotations[m] in this order. Adjacent rotations, including the one-body term,
+ * are already fused into single matrices.
+ */
+struct TrotterStep {
+    std::vector<MatrixXcd> rotations;             ///< m + 1 fused orbital rotations
+    std::vector<std::pair<size_t, double>> diags; ///< (term index, time) pairs
+};
+
+/**
+ * @brief Builds one fused Trotter step of a double-factorized Hamiltonian.
+ *
+ * The one-body term is exp(-i h' dt), itself an orbital rotation, and term k is
+ * W(U_k) exp(-i dt 1/2 sum Z^k_ij n_i n_j) W(U_k^dagger). Consecutive rotations
+ * are multiplied together so each step needs only m + 1 rotations.
+ *
+ * @param hamiltonian The double-factorized Hamiltonian
+ * @param dt Time step
+ * @param order 1 for the first-order product formula, 2 for the symmetric
+ * (Strang) splitting
+ * @return The fused step
+ */
+TrotterStep trotter_step_double_factorized(
+    const DoubleFactorizedHamiltonian &hamiltonian, double dt, int order
+)
+{
+    if (order != 1 && order != 2) {
+        throw std::invalid_argument("Trotter order must be 1 or 2");
+    }
+    const Complex I(0.0, 1.0);
+    const size_t n_terms = hamiltonian.diag_coulomb_mats.size();
+
+    // Terms as (index, time) with index n_terms standing for the one-body term.
+    std::vector<std::pair<size_t, double>> sequence;
+    if (order == 1) {
+        sequence.emplace_back(n_terms, dt);
+        for (size_t k = 0; k < n_terms; ++k) {
+            sequence.emplace_back(k, dt);
+        }
+    } else {
+        sequence.emplace_back(n_terms, 0.5 * dt);
+        for (size_t k = 0; k + 1 < n_terms; ++k) {
+            sequence.emplace_back(k, 0.5 * dt);
+        }
+        if (n_terms > 0) {
+            sequence.emplace_back(n_terms - 1, dt);
+            for (size_t k = n_terms - 1; k-- > 0;) {
+                sequence.emplace_back(k, 0.5 * dt);
+            }
+            sequence.emplace_back(n_terms, 0.5 * dt);
+        } else {
+            sequence.back().second = dt;
+        }
+    }
+
+    const auto n = static_cast<Index>(hamiltonian.norb);
+    TrotterStep step;
+    MatrixXcd pending = MatrixXcd::Identity(n, n);
+    for (const auto &[k, time] : sequence) {
+        if (k == n_terms) {
+            MatrixXcd generator = -I * time * hamiltonian.one_body_tensor;
+            pending = linalg::expm(generator) * pending;
+        } else {
+            MatrixXcd rotation = hamiltonian.orbital_rotations[k].cast<Complex>();
+            step.rotations.push_back(rotation.adjoint() * pending);
+            step.diags.emplace_back(k, time);
+            pending = rotation;
+        }
+    }
+    step.rotations.push_back(pending);
+    return step;
+}
+
+/**
+ * @brief Orbital rotation with its Givens decomposition cached.
+ *
+ * The subspace index lists only depend on the rotated orbitals and the electron
+ * count, so they are shared by all rotations through an external cache. Where
+ * prefer_string_space_rotation favors it, the rotation is instead applied as one
+ * ZGEMM with its string-space matrix, built once per electron count. The Givens
+ * decomposition is computed on its first use only.
+ */
+class CachedOrbitalRotation
+{
+  public:
+    /// Index slices of the Givens rotations (keyed by (i, j)) and phase shifts
+    /// (keyed by (i, i)) for one electron count.
+    using IndexCache = std::map<
+        std::pair<size_t, size_t>, std::pair<std::vector<size_t>, std::vector<size_t>>>;
+
+    CachedOrbitalRotation(const MatrixXcd &mat, uint64_t norb)
+      : norb(norb), mat(mat),
+        n_givens(givens_rotation_count(linalg::detect_orbital_blocks(mat)))
+    {
+    }
+
+    /**
+     * @brief Applies the rotation to the rows of a reshaped state vector.
+     * @param vec State vector reshaped so that rows index the rotated spin sector
+     * @param nelec Number of electrons in the rotated spin sector
+     * @param cache Subspace index cache for this electron count
+     */
+    void apply(MatrixXcd &vec, size_t nelec, IndexCache &cache) const
+    {
+        if (prefer_string_space_rotation(
+                norb, nelec, static_cast<size_t>(vec.cols()), n_givens, true
+            )) {
+            auto it = string_space.find(nelec);
+            if (it == string_space.end()) {
+                it = string_space
+                         .emplace(nelec, string_space_rotation(mat, norb, nelec))
+                         .first;
+            }
+            apply_string_space_rotation_in_place(vec, it->second);
+            return;
+        }
+        if (!decomposition) {
+            decomposition = linalg::givens_decomposition(mat);
+        }
+        const auto &[rotations, phase_shifts] = *decomposition;
+        for (const auto &rotation : rotations) {
+            auto [it, inserted] = cache.try_emplace({rotation.i, rotation.j});
+            auto &[slice1, slice2] = it->second;
+            if (inserted) {
+                auto indices =
+                    zero_one_subspace_indices(norb, nelec, {rotation.i, rotation.j});
+                auto half = static_cast<std::ptrdiff_t>(indices.size() / 2);
+                slice1.assign(indices.begin(), indices.begin() + half);
+                slice2.assign(indices.begin() + half, indices.end());
+            }
+            apply_givens_rotation_in_place(
+                vec, rotation.c, std::conj(rotation.s), slice1, slice2
+            );
+        }
+        for (size_t i = 0; i < static_cast<size_t>(phase_shifts.size()); ++i) {
+            auto [it, inserted] = cache.try_emplace({i, i});
+            if (inserted) {
+                it->second.first = one_subspace_indices(norb, nelec, {i});
+            }
+            apply_phase_shift_in_place(
+                vec, phase_shifts(static_cast<Index>(i)), it->second.first
+            );
+        }
+    }
+
+  private:
+    uint64_t norb;
+    MatrixXcd mat;
+    /// Givens rotation count estimated from the orbital blocks of mat
+    size_t n_givens;
+    /// Givens decomposition, computed on first use
+    mutable std::optional<std::pair<std::vector<linalg::GivensRotation>, VectorXcd>>
+        decomposition;
+    /// String-space matrices by electron count, built on first use
+    mutable std::map<size_t, MatrixXcd> string_space;
+};
+
+/**
+ * @brief Simulates time evolution by a double-factorized Hamiltonian with a
+ * Trotter product formula.
+ *
+ * Adjacent orbital rotations are fused within each step and across step
+ * boundaries, so one step costs m + 1 rotations instead of 2m + 1. Givens
+ * decompositions, subspace index lists, and diagonal Coulomb phases are computed
+ * once and reused by every step.
+ *
+ * @param vec Input state vector
+ * @param hamiltonian The double-factorized Hamiltonian
+ * @param time Total evolution time
+ * @param norb Number of spatial orbitals
+ * @param nelec (alpha, beta) electron counts
+ * @param n_steps Number of Trotter steps
+ * @param order 1 for first order, 2 for the symmetric second-order formula
+ * @return The evolved state vector
+ */
+VectorXcd simulate_trotter_double_factorized(
+    const VectorXcd &vec, const DoubleFactorizedHamiltonian &hamiltonian, double time,
+    uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec, int n_steps = 1,
+    int order = 1
+)
+{
+    if (n_steps < 1) {
+        throw std::invalid_argument("n_steps must be positive");
+    }
+    const Complex I(0.0, 1.0);
+    const double dt = time / static_cast<double>(n_steps);
+    TrotterStep step = trotter_step_double_factorized(hamiltonian, dt, order);
+
+    const size_t n_alpha = nelec.first;
+    const size_t n_beta = nelec.second;
+    const auto dim_a = static_cast<Index>(binomial(norb, n_alpha));
+    const auto dim_b = static_cast<Index>(binomial(norb, n_beta));
+    MatrixXcd reshaped = Map<const MatrixXcd>(vec.data(), dim_a, dim_b);
+
+    CachedOrbitalRotation::IndexCache cache_a, cache_b;
+    auto rotate = [&](const CachedOrbitalRotation &rotation) {
+        rotation.apply(reshaped, n_alpha, cache_a);
+        MatrixXcd transposed = reshaped.transpose();
+        rotation.apply(transposed, n_beta, n_alpha == n_beta ? cache_a : cache_b);
+        reshaped = transposed.transpose();
+    };
+
+    const size_t m = step.diags.size();
+    if (m == 0) {
+        // One-body Hamiltonian: all steps fuse into a single rotation.
+        MatrixXcd total =
+            MatrixXcd::Identity(static_cast<Index>(norb), static_cast<Index>(norb));
+        for (int s = 0; s < n_steps; ++s) {
+            total = step.rotations[0] * total;
+        }
+        rotate(CachedOrbitalRotation(total, norb));
+    } else {
+        std::vector<CachedOrbitalRotation> rotations;
+        rotations.reserve(m + 2);
+        for (const auto &rotation : step.rotations) {
+            rotations.emplace_back(rotation, norb);
+        }
+        // The last rotation of a step and the first of the next one fuse.
+        CachedOrbitalRotation wrap(step.rotations[0] * step.rotations[m], norb);
+
+        std::vector<size_t> orb_list(norb);
+        std::iota(orb_list.begin(), orb_list.end(), 0);
+        auto occupations_a = gen_occslst(orb_list, n_alpha);
+        auto occupations_b = gen_occslst(orb_list, n_beta);
+        std::vector<MatExp> mat_exps;
+        mat_exps.reserve(m);
+        for (const auto &[k, t] : step.diags) {
+            Mat mat{
+                MatType::Single,
+                hamiltonian.diag_coulomb_mats[k].cast<Complex>(),
+                {std::nullopt, std::nullopt, std::nullopt}
+            };
+            mat_exps.push_back(get_mat_exp(mat, norb, false, t));
+        }
+
+        rotate(rotations[0]);
+        for (int s = 0; s < n_steps; ++s) {
+            for (size_t i = 0; i < m; ++i) {
+                apply_diag_coulomb_evolution_in_place_num_rep(
+                    reshaped, norb, mat_exps[i], occupations_a, occupations_b
+                );
+                if (i + 1 < m) {
+                    rotate(rotations[i + 1]);
+                }
+            }
+            rotate(s + 1 < n_steps ? wrap : rotations[m]);
+        }
+    }
+
+    VectorXcd result = Map<VectorXcd>(reshaped.data(), dim_a * dim_b);
+    return std::exp(-I * hamiltonian.constant * time) * result;
+}
+
+/**
+ * @brief Generates the Jordan-Wigner circuit of the Trotter product formula
+ * simulated by simulate_trotter_double_factorized.
+ *
+ * The gate sequence uses the same fused orbital rotations. The global phase of
+ * the constant term is omitted.
+ *
+ * @param qubits List of 2*norb qubit indices (alpha followed by beta spin
+ * orbitals)
+ * @param hamiltonian The double-factorized Hamiltonian
+ * @param time Total evolution time
+ * @param n_steps Number of Trotter steps
+ * @param order 1 for first order, 2 for the symmetric second-order formula
+ * @return Vector of circuit instructions
+ */
+std::vector<CircuitInstruction> simulate_trotter_double_factorized_jw(
+    const std::vector<uint32_t> &qubits, const DoubleFactorizedHamiltonian &hamiltonian,
+    double time, int n_steps = 1, int order = 1
+)
+{
+    if (n_steps < 1) {
+        throw std::invalid_argument("n_steps must be positive");
+    }
+    const uint64_t norb = hamiltonian.norb;
+    TrotterStep step = trotter_step_double_factorized(
+        hamiltonian, time / static_cast<double>(n_steps), order
+    );
+    const size_t m = step.diags.size();
+
+    std::vector<CircuitInstruction> instructions;
+    auto append = [&](const std::vector<CircuitInstruction> &other) {
+        instructions.insert(instructions.end(), other.begin(), other.end());
+    };
+    auto rotation_jw = [&](const MatrixXcd &mat) {
+        OrbitalRotation rotation{
+            OrbitalRotationType::Spinless, mat, {std::nullopt, std::nullopt}
+        };
+        return OrbitalRotationJW(norb, rotation, false).instructions(qubits);
+    };
+
+    if (m == 0) {
+        MatrixXcd total =
+            MatrixXcd::Identity(static_cast<Index>(norb), static_cast<Index>(norb));
+        for (int s = 0; s < n_steps; ++s) {
+            total = step.rotations[0] * total;
+        }
+        return rotation_jw(total);
+    }
+
+    // Gate sequences of each distinct block are generated once and repeated.
+    std::vector<std::vector<CircuitInstruction>> rotation_instructions;
+    rotation_instructions.reserve(m + 1);
+    for (const auto &rotation : step.rotations) {
+        rotation_instructions.push_back(rotation_jw(rotation));
+    }
+    auto wrap_instructions = rotation_jw(step.rotations[0] * step.rotations[m]);
+    std::vector<std::vector<CircuitInstruction>> diag_instructions;
+    diag_instructions.reserve(m);
+    for (const auto &[k, t] : step.diags) {
+        Mat mat{
+            MatType::Single,
+            hamiltonian.diag_coulomb_mats[k].cast<Complex>(),
+            {std::nullopt, std::nullopt, std::nullopt}
+        };
+        diag_instructions.push_back(
+            DiagCoulombEvolutionJW(norb, mat, t, false).instructions(qubits)
+        );
+    }
+
+    append(rotation_instructions[0]);
+    for (int s = 0; s < n_steps; ++s) {
+        for (size_t i = 0; i < m; ++i) {
+            append(diag_instructions[i]);
+            if (i + 1 < m) {
+                append(rotation_instructions[i + 1]);
+            }
+        }
+        append(s + 1 < n_steps ? wrap_instructions : rotation_instructions[m]);
+    }
+    return instructions;
+}
+
+} // namespace ffsim
+
+#endif // TROTTER_HPP
@@ -102,80 +102,147 @@ std::vector<CircuitInstruction> ucj_op_spin_balanced_jw(
     const std::vector<uint32_t> &qubits, const UCJOpSpinBalanced &ucj_op
 )
 {
-    std::vector<CircuitInstruction> instructions;
     uint64_t norb = ucj_op.norb();
     size_t n_reps = ucj_op.n_reps();
 
+    // Every repetition contributes three independent segments, the two orbital
+    // rotations and the diagonal Coulomb evolution between them, generated
+    // concurrently and concatenated in this order.
+    std::vector<SegmentBuilder> builders;
     for (int rep = 0; rep < n_reps; ++rep) {
-        MatrixXcd diag_coulomb_mat_aa(norb, norb);
-        MatrixXcd diag_coulomb_mat_ab(norb, norb);
-        for (int i = 0; i < norb; ++i) {
-            for (int j = 0; j < norb; ++j) {
-                diag_coulomb_mat_aa(i, j) = ucj_op.diag_coulomb_mats(rep, 0, i, j);
-                diag_coulomb_mat_ab(i, j) = ucj_op.diag_coulomb_mats(rep, 1, i, j);
+        builders.emplace_back([&, rep] {
+            MatrixXcd orbital_rotation(norb, norb);
+            for (int i = 0; i < norb; ++i) {
+                for (int j = 0; j < norb; ++j) {
+                    orbital_rotation(i, j) =
+                        std::conj(ucj_op.orbital_rotations(rep, j, i));
+                }
             }
-        }
+            auto rot1 = OrbitalRotationJW(
+                norb,
+                OrbitalRotation{
+                    OrbitalRotationType::Spinless, orbital_rotation,
+                    std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
+                },
+                true, 1e-5, 1e-8
+            );
+            return rot1.instructions(qubits);
+        });
 
-        MatrixXcd orbital_rotation(norb, norb);
-        for (int i = 0; i < norb; ++i) {
-            for (int j = 0; j < norb; ++j) {
-                orbital_rotation(i, j) = std::conj(ucj_op.orbital_rotations(rep, j, i));
+        builders.emplace_back([&, rep] {
+            MatrixXcd diag_coulomb_mat_aa(norb, norb);
+            MatrixXcd diag_coulomb_mat_ab(norb, norb);
+            for (int i = 0; i < norb; ++i) {
+                for (int j = 0; j < norb; ++j) {
+                    diag_coulomb_mat_aa(i, j) = ucj_op.diag_coulomb_mats(rep, 0, i, j);
+                    diag_coulomb_mat_ab(i, j) = ucj_op.diag_coulomb_mats(rep, 1, i, j);
+                }
             }
-        }
+            auto diag = DiagCoulombEvolutionJW(
+                norb,
+                Mat{MatType::Triple,
+                    MatrixXcd(),
+                    {diag_coulomb_mat_aa, diag_coulomb_mat_ab, diag_coulomb_mat_aa}},
+                -1.0, false
+            );
+            return diag.instructions(qubits);
+        });
 
-        auto rot1 = OrbitalRotationJW(
-            norb,
-            OrbitalRotation{
-                OrbitalRotationType::Spinless, orbital_rotation,
-                std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
-            },
-            true, 1e-5, 1e-8
-        );
-        auto inst1 = rot1.instructions(qubits);
-        instructions.insert(instructions.end(), inst1.begin(), inst1.end());
+        builders.emplace_back([&, rep] {
+            MatrixXcd orbital_rotation2(norb, norb);
+            for (int i = 0; i < norb; ++i) {
+                for (int j = 0; j < norb; ++j) {
+                    orbital_rotation2(i, j) = ucj_op.orbital_rotations(rep, i, j);
+                }
+            }
+            auto rot2 = OrbitalRotationJW(
+                norb,
+                OrbitalRotation{
+                    OrbitalRotationType::Spinless, orbital_rotation2,
+                    std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
+                },
+                true, 1e-5, 1e-8
+            );
+            return rot2.instructions(qubits);
+        });
+    }
 
-        auto diag = DiagCoulombEvolutionJW(
-            norb,
-            Mat{MatType::Triple,
-                MatrixXcd(),
-                {diag_coulomb_mat_aa, diag_coulomb_mat_ab, diag_coulomb_mat_aa}},
-            -1.0, false
-        );
-        auto inst2 = diag.instructions(qubits);
-        instructions.insert(instructions.end(), inst2.begin(), inst2.end());
+    if (ucj_op.final_orbital_rotation.has_value()) {
+        builders.emplace_back([&] {
+            auto final_orbital_rotation = OrbitalRotationJW(
+                norb,
+                OrbitalRotation{
+                    OrbitalRotationType::Spinless,
+                    ucj_op.final_orbital_rotation.value(),
+                    std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
+                },
+                true, 1e-5, 1e-8
+            );
+            return final_orbital_rotation.instructions(qubits);
+        });
+    }
+
+    return build_segments_concurrently(builders);
+}
 
-        MatrixXcd orbital_rotation2(norb, norb);
-        for (int i = 0; i < norb; ++i) {
-            for (int j = 0; j < norb; ++j) {
-                orbital_rotation2(i, j) = ucj_op.orbital_rotations(rep, i, j);
+/**
+ * @brief Applies a spin-balanced UCJ operator to a state vector.
+ *
+ * Applies the same sequence as ucj_op_spin_balanced_jw: for each repetition the
+ * diagonal Coulomb evolution conjugated by the orbital rotation, followed by the
+ * optional final orbital rotation.
+ *
+ * @param vec Input state vector
+ * @param ucj_op The UCJOpSpinBalanced operator
+ * @param nelec (alpha, beta) electron counts
+ * @return The transformed state vector
+ */
+VectorXcd apply_ucj_op_spin_balanced(
+    const VectorXcd &vec, const UCJOpSpinBalanced &ucj_op,
+    const std::pair<uint64_t, uint64_t> &nelec
+)
+{
+    const uint64_t norb = ucj_op.norb();
+    const auto n = static_cast<Index>(norb);
+    const Electron electron{ElectronType::Spinfull, 0, nelec};
+    VectorXcd result = vec;
+
+    for (Index rep = 0; rep < static_cast<Index>(ucj_op.n_reps()); ++rep) {
+        MatrixXcd diag_coulomb_mat_aa(n, n);
+        MatrixXcd diag_coulomb_mat_ab(n, n);
+        MatrixXcd orbital_rotation(n, n);
+        for (Index i = 0; i < n; ++i) {
+            for (Index j = 0; j < n; ++j) {
+                diag_coulomb_mat_aa(i, j) = ucj_op.diag_coulomb_mats(rep, 0, i, j);
+                diag_coulomb_mat_ab(i, j) = ucj_op.diag_coulomb_mats(rep, 1, i, j);
+                orbital_rotation(i, j) = ucj_op.orbital_rotations(rep, i, j);
             }
         }
-        auto rot2 = OrbitalRotationJW(
-            norb,
+        result = apply_diag_coulomb_evolution(
+            result,
+            Mat{MatType::Triple,
+                MatrixXcd(),
+                {diag_coulomb_mat_aa, diag_coulomb_mat_ab, diag_coulomb_mat_aa}},
+            -1.0, norb, electron,
             OrbitalRotation{
-                OrbitalRotationType::Spinless, orbital_rotation2,
+                OrbitalRotationType::Spinless, orbital_rotation,
                 std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
             },
-            true, 1e-5, 1e-8
+            false
         );
-        auto inst3 = rot2.instructions(qubits);
-        instructions.insert(instructions.end(), inst3.begin(), inst3.end());
     }
 
     if (ucj_op.final_orbital_rotation.has_value()) {
-        auto final_orbital_rotation = OrbitalRotationJW(
-            norb,
+        result = apply_orbital_rotation(
+            result,
             OrbitalRotation{
                 OrbitalRotationType::Spinless, ucj_op.final_orbital_rotation.value(),
                 std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
             },
-            true, 1e-5, 1e-8
+            norb, electron
         );
-        auto inst4 = final_orbital_rotation.instructions(qubits);
-        instructions.insert(instructions.end(), inst4.begin(), inst4.end());
     }
-
-    return instructions;
+    return result;
 }
 
 /**
@@ -241,7 +308,6 @@ std::vector<CircuitInstruction> hf_and_ucj_op_spin_balanced_jw(
     const UCJOpSpinBalanced &ucj_op
 )
 {
-    std::vector<CircuitInstruction> instructions;
     uint64_t norb = ucj_op.norb();
 
     if (qubits.size() != 2 * norb) {
@@ -255,54 +321,64 @@ std::vector<CircuitInstruction> hf_and_ucj_op_spin_balanced_jw(
 
     const size_t n_reps = ucj_op.n_reps();
 
-    PrepareSlaterDeterminantJW slater_determinant(
-        norb, {n_alpha, n_beta}, std::nullopt, qubits, true, 1e-5, 1e-8
-    );
+    // The state preparation, the diagonal Coulomb evolution of each repetition
+    // and the closing orbital rotation are independent segments, generated
+    // concurrently and concatenated in this order.
+    std::vector<SegmentBuilder> builders;
+    builders.emplace_back([&] {
+        PrepareSlaterDeterminantJW slater_determinant(
+            norb, {n_alpha, n_beta}, std::nullopt, qubits, true, 1e-5, 1e-8
+        );
 
-    MatrixXcd orbital_rotation = MatrixXcd(norb, norb);
-    for (uint64_t i = 0; i < norb; ++i) {
-        for (uint64_t j = 0; j < norb; ++j) {
-            orbital_rotation(static_cast<Index>(i), static_cast<Index>(j)) = std::conj(
-                ucj_op.orbital_rotations(0, static_cast<long>(j), static_cast<long>(i))
-            );
+        MatrixXcd orbital_rotation = MatrixXcd(norb, norb);
+        for (uint64_t i = 0; i < norb; ++i) {
+            for (uint64_t j = 0; j < norb; ++j) {
+                orbital_rotation(static_cast<Index>(i), static_cast<Index>(j)) =
+                    std::conj(ucj_op.orbital_rotations(
+                        0, static_cast<long>(j), static_cast<long>(i)
+                    ));
+            }
         }
-    }
 
-    MatrixXcd orbital_rotation_a = orbital_rotation;
-    MatrixXcd orbital_rotation_b = orbital_rotation;
+        MatrixXcd orbital_rotation_a = orbital_rotation;
+        MatrixXcd orbital_rotation_b = orbital_rotation;
 
-    MatrixXcd combined_mat_a =
-        orbital_rotation_a * slater_determinant.orbital_rotation_a();
-    MatrixXcd combined_mat_b =
-        orbital_rotation_b * slater_determinant.orbital_rotation_b();
+        MatrixXcd combined_mat_a =
+            orbital_rotation_a * slater_determinant.orbital_rotation_a();
+        MatrixXcd combined_mat_b =
+            orbital_rotation_b * slater_determinant.orbital_rotation_b();
 
-    slater_determinant.orbital_rotation_a() = combined_mat_a;
-    slater_determinant.orbital_rotation_b() = combined_mat_b;
+        slater_determinant.orbital_rotation_a() = combined_mat_a;
+        slater_determinant.orbital_rotation_b() = combined_mat_b;
 
-    std::vector<CircuitInstruction> slater_inst = slater_determinant.instructions();
-    instructions.insert(instructions.end(), slater_inst.begin(), slater_inst.end());
+        return slater_determinant.instructions();
+    });
 
     for (int rep = 0; rep < n_reps; ++rep) {
-        MatrixXcd diag_coulomb_mat_aa(norb, norb);
-        MatrixXcd diag_coulomb_mat_ab(norb, norb);
-        for (int i = 0; i < norb; ++i) {
-            for (int j = 0; j < norb; ++j) {
-                diag_coulomb_mat_aa(i, j) = ucj_op.diag_coulomb_mats(rep, 0, i, j);
-                diag_coulomb_mat_ab(i, j) = ucj_op.diag_coulomb_mats(rep, 1, i, j);
+        builders.emplace_back([&, rep] {
+            MatrixXcd diag_coulomb_mat_aa(norb, norb);
+            MatrixXcd diag_coulomb_mat_ab(norb, norb);
+            for (int i = 0; i < norb; ++i) {
+                for (int j = 0; j < norb; ++j) {
+                    diag_coulomb_mat_aa(i, j) = ucj_op.diag_coulomb_mats(rep, 0, i, j);
+                    diag_coulomb_mat_ab(i, j) = ucj_op.diag_coulomb_mats(rep, 1, i, j);
+                }
             }
-        }
 
-        auto diag = DiagCoulombEvolutionJW(
-            norb,
-            Mat{MatType::Triple,
-                MatrixXcd(),
-                {diag_coulomb_mat_aa, diag_coulomb_mat_ab, diag_coulomb_mat_aa}},
-            -1.0, false
-        );
-        auto inst2 = diag.instructions(qubits);
-        instructions.insert(instructions.end(), inst2.begin(), inst2.end());
+            auto diag = DiagCoulombEvolutionJW(
+                norb,
+                Mat{MatType::Triple,
+                    MatrixXcd(),
+                    {diag_coulomb_mat_aa, diag_coulomb_mat_ab, diag_coulomb_mat_aa}},
+                -1.0, false
+            );
+            return diag.instructions(qubits);
+        });
+    }
 
-        if (rep == n_reps - 1) {
+    if (n_reps > 0) {
+        const int rep = static_cast<int>(n_reps) - 1;
+        builders.emplace_back([&, rep] {
             MatrixXcd orbital_rotation2(norb, norb);
             for (int i = 0; i < norb; ++i) {
                 for (int j = 0; j < norb; ++j) {
@@ -310,37 +386,22 @@ std::vector<CircuitInstruction> hf_and_ucj_op_spin_balanced_jw(
                 }
             }
             if (ucj_op.final_orbital_rotation.has_value()) {
-                auto rot2 = OrbitalRotationJW(
-                    norb,
-                    OrbitalRotation{
-                        OrbitalRotationType::Spinless,
-                        ucj_op.final_orbital_rotation.value() * orbital_rotation2,
-                        std::array<std::optional<MatrixXcd>, 2>{
-                            std::nullopt, std::nullopt
-                        }
-                    },
-                    true, 1e-5, 1e-8
-                );
-                auto inst3 = rot2.instructions(qubits);
-                instructions.insert(instructions.end(), inst3.begin(), inst3.end());
-            } else {
-                auto rot2 = OrbitalRotationJW(
-                    norb,
-                    OrbitalRotation{
-                        OrbitalRotationType::Spinless, orbital_rotation2,
-                        std::array<std::optional<MatrixXcd>, 2>{
-                            std::nullopt, std::nullopt
-                        }
-                    },
-                    true, 1e-5, 1e-8
-                );
-                auto inst3 = rot2.instructions(qubits);
-                instructions.insert(instructions.end(), inst3.begin(), inst3.end());
+                orbital_rotation2 =
+                    (ucj_op.final_orbital_rotation.value() * orbital_rotation2).eval();
             }
-        }
+            auto rot2 = OrbitalRotationJW(
+                norb,
+                OrbitalRotation{
+                    OrbitalRotationType::Spinless, orbital_rotation2,
+                    std::array<std::optional<MatrixXcd>, 2>{std::nullopt, std::nullopt}
+                },
+                true, 1e-5, 1e-8
+            );
+            return rot2.instructions(qubits);
+        });
     }
 
-    return instructions;
+    return build_segments_concurrently(builders);
 }
 
 } // namespace ffsim
@@ -0,0 +1,328 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef UCJ_CHECKPOINT_HPP
+#define UCJ_CHECKPOINT_HPP
+
+#include "gates/diag_coulomb.hpp"
+#include "gates/orbital_rotation.hpp"
+#include "linalg/expm.hpp"
+#include "states.hpp"
+#include "trotter.hpp"
+#include "ucjop_spinbalanced.hpp"
+#include "utils.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+
+/**
+ * @brief State-vector simulator of the LUCJ ansatz that re-applies only the
+ * repetitions whose parameters changed since the previous call.
+ *
+ * The state is prepared from Hartree-Fock with the operator given by
+ * UCJOpSpinBalanced::from_parameters. After each repetition the state is kept
+ * as a checkpoint while the memory budget allows. A new parameter vector is
+ * compared with the previous one block by block, and the simulation restarts
+ * from the deepest checkpoint before the first changed repetition; so an
+ * optimizer that varies the last repetitions only pays for those.
+ *
+ * When the budget is exhausted the checkpoint closest to the one before it is
+ * evicted, which keeps the stored states spread over the depth. An evicted
+ * state is recomputed from the nearest earlier checkpoint when it is needed.
+ *
+ * The operators of each repetition, its orbital rotations with their Givens
+ * decompositions and string-space matrices and its diagonal Coulomb phases, are
+ * kept as well and rebuilt only for repetitions whose own parameters changed.
+ */
+class UCJCheckpointSimulator
+{
+  public:
+    /// Repetitions applied and skipped over all calls.
+    struct Stats {
+        size_t reps_applied = 0;
+        size_t reps_reused = 0;
+        size_t evictions = 0;
+    };
+
+    /**
+     * @brief Creates a simulator for one ansatz layout.
+     *
+     * @param norb Number of spatial orbitals
+     * @param nelec (alpha, beta) electron counts
+     * @param n_reps Number of repetitions
+     * @param interaction_pairs Optional interaction masks
+     * @param with_final_orbital_rotation Whether the parameters include a final
+     * orbital rotation
+     * @param memory_budget Bytes available for checkpoints
+     */
+    UCJCheckpointSimulator(
+        uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec, size_t n_reps,
+        const std::array<std::optional<std::vector<std::pair<uint64_t, uint64_t>>>, 2>
+            &interaction_pairs,
+        bool with_final_orbital_rotation, size_t memory_budget = size_t(1) << 30
+    )
+      : norb(norb), nelec(nelec), n_reps(n_reps),
+        with_final_orbital_rotation(with_final_orbital_rotation),
+        operators(n_reps), checkpoints(n_reps)
+    {
+        std::vector<std::pair<uint64_t, uint64_t>> triu;
+        for (size_t i = 0; i < norb; ++i) {
+            for (size_t j = i; j < norb; ++j) {
+                triu.emplace_back(i, j);
+            }
+        }
+        pairs_aa = interaction_pairs[0].value_or(triu);
+        pairs_ab = interaction_pairs[1].value_or(triu);
+        n_params = UCJOpSpinBalanced::n_params(
+            norb, n_reps, interaction_pairs, with_final_orbital_rotation
+        );
+        rep_stride =
+            static_cast<Index>(norb * norb + pairs_aa.size() + pairs_ab.size());
+
+        std::vector<size_t> orb_list(norb);
+        std::iota(orb_list.begin(), orb_list.end(), 0);
+        occupations_a = gen_occslst(orb_list, nelec.first);
+        occupations_b = gen_occslst(orb_list, nelec.second);
+        const size_t state_bytes =
+            occupations_a.size() * occupations_b.size() * sizeof(Complex);
+        capacity = memory_budget / state_bytes;
+    }
+
+    /**
+     * @brief Returns the LUCJ state for a parameter vector.
+     *
+     * @param params Real-valued parameter vector, laid out as in
+     * UCJOpSpinBalanced::from_parameters
+     * @return The state vector
+     * @throws std::runtime_error if the number of parameters is wrong
+     */
+    VectorXcd state(const VectorXcd &params)
+    {
+        if (static_cast<size_t>(params.size()) != n_params) {
+            throw std::runtime_error(
+                "Expected " + std::to_string(n_params) + " parameters, but got " +
+                std::to_string(params.size())
+            );
+        }
+        const size_t first = update_operators(params);
+        last_params = params;
+        for (size_t k = first; k < n_reps; ++k) {
+            checkpoints[k].reset();
+        }
+
+        // Restart from the deepest state kept before the first change.
+        size_t rep = first;
+        while (rep > 0 && !checkpoints[rep - 1]) {
+            --rep;
+        }
+        MatrixXcd state;
+        if (rep > 0) {
+            state = *checkpoints[rep - 1];
+        } else {
+            state = MatrixXcd::Zero(
+                static_cast<Index>(occupations_a.size()),
+                static_cast<Index>(occupations_b.size())
+            );
+            state(0, 0) = 1.0;
+        }
+        counters.reps_reused += rep;
+        for (; rep < n_reps; ++rep) {
+            apply_rep(state, params, rep);
+            ++counters.reps_applied;
+            if (!checkpoints[rep]) {
+                store(rep, state);
+            }
+        }
+        if (with_final_orbital_rotation) {
+            if (!final_rotation) {
+                const Index offset = static_cast<Index>(n_reps) * rep_stride;
+                final_rotation.emplace(rotation_from_parameters(params, offset), norb);
+            }
+            rotate(state, *final_rotation);
+        }
+        return Map<VectorXcd>(state.data(), state.size());
+    }
+
+    /// Drops all checkpoints, e.g. to release their memory.
+    void clear()
+    {
+        for (auto &checkpoint : checkpoints) {
+            checkpoint.reset();
+        }
+        for (auto &rep_operators : operators) {
+            rep_operators.reset();
+        }
+        final_rotation.reset();
+        last_params.resize(0);
+    }
+
+    const Stats &stats() const
+    {
+        return counters;
+    }
+
+  private:
+    /// Operators of one repetition
+    struct RepOperators {
+        CachedOrbitalRotation rotation_in;  ///< Adjoint of the orbital rotation
+        CachedOrbitalRotation rotation_out; ///< The orbital rotation
+        MatExp mat_exp;                     ///< Diagonal Coulomb phases
+    };
+
+    /// Drops the operators of the repetitions, and of the final rotation, whose
+    /// parameters differ from the previous call. Returns the first such
+    /// repetition, n_reps if only the final rotation (or nothing) changed.
+    size_t update_operators(const VectorXcd &params)
+    {
+        const bool same_layout = last_params.size() == params.size();
+        size_t first = n_reps;
+        for (size_t rep = 0; rep < n_reps; ++rep) {
+            const Index offset = static_cast<Index>(rep) * rep_stride;
+            if (!same_layout || params.segment(offset, rep_stride) !=
+                                    last_params.segment(offset, rep_stride)) {
+                operators[rep].reset();
+                first = std::min(first, rep);
+            }
+        }
+        const Index final_offset = static_cast<Index>(n_reps) * rep_stride;
+        if (!same_layout || params.tail(params.size() - final_offset) !=
+                                last_params.tail(last_params.size() - final_offset)) {
+            final_rotation.reset();
+        }
+        return first;
+    }
+
+    /// exp of the orbital rotation generator stored at offset.
+    MatrixXcd rotation_from_parameters(const VectorXcd &params, Index offset) const
+    {
+        const auto n = static_cast<Index>(norb);
+        MatrixXcd generator = orbital_rotation_generator_from_parameters(
+            params.segment(offset, n * n), static_cast<int>(norb), false
+        );
+        return linalg::expm(generator);
+    }
+
+    /// Keeps the state after repetition rep, evicting the checkpoint with the
+    /// smallest gap to its predecessor if the budget is full; that may be the
+    /// new state itself.
+    void store(size_t rep, const MatrixXcd &state)
+    {
+        if (capacity == 0) {
+            return;
+        }
+        size_t stored = 0;
+        for (const auto &checkpoint : checkpoints) {
+            stored += checkpoint ? 1 : 0;
+        }
+        if (stored >= capacity) {
+            size_t victim = rep;
+            size_t victim_gap = SIZE_MAX;
+            size_t previous = 0; // one past the previous checkpoint, 0 for HF
+            for (size_t k = 0; k < n_reps; ++k) {
+                if (!checkpoints[k] && k != rep) {
+                    continue;
+                }
+                if (k + 1 - previous < victim_gap) {
+                    victim = k;
+                    victim_gap = k + 1 - previous;
+                }
+                previous = k + 1;
+            }
+            ++counters.evictions;
+            if (victim == rep) {
+                return;
+            }
+            checkpoints[victim].reset();
+        }
+        checkpoints[rep] = state;
+    }
+
+    void apply_rep(MatrixXcd &state, const VectorXcd &params, size_t rep)
+    {
+        if (!operators[rep]) {
+            const auto n = static_cast<Index>(norb);
+            const Index offset = static_cast<Index>(rep) * rep_stride;
+            MatrixXcd rotation = rotation_from_parameters(params, offset);
+            MatrixXcd mat_aa = MatrixXcd::Zero(n, n);
+            MatrixXcd mat_ab = MatrixXcd::Zero(n, n);
+            Index index = offset + n * n;
+            for (const auto &[i, j] : pairs_aa) {
+                mat_aa(i, j) = mat_aa(j, i) = params(index++);
+            }
+            for (const auto &[i, j] : pairs_ab) {
+                mat_ab(i, j) = mat_ab(j, i) = params(index++);
+            }
+            Mat mat{MatType::Triple, MatrixXcd(), {mat_aa, mat_ab, mat_aa}};
+            operators[rep].emplace(RepOperators{
+                CachedOrbitalRotation(rotation.adjoint(), norb),
+                CachedOrbitalRotation(rotation, norb),
+                get_mat_exp(mat, norb, false, -1.0)
+            });
+        }
+        const auto &ops = *operators[rep];
+        rotate(state, ops.rotation_in);
+        apply_diag_coulomb_evolution_in_place_num_rep(
+            state, norb, ops.mat_exp, occupations_a, occupations_b
+        );
+        rotate(state, ops.rotation_out);
+    }
+
+    void rotate(MatrixXcd &state, const CachedOrbitalRotation &rotation)
+    {
+        rotation.apply(state, nelec.first, cache_a);
+        MatrixXcd transposed = state.transpose();
+        rotation.apply(
+            transposed, nelec.second, nelec.first == nelec.second ? cache_a : cache_b
+        );
+        state = transposed.transpose();
+    }
+
+    uint64_t norb;
+    std::pair<uint64_t, uint64_t> nelec;
+    size_t n_reps;
+    bool with_final_orbital_rotation;
+    std::vector<std::pair<uint64_t, uint64_t>> pairs_aa;
+    std::vector<std::pair<uint64_t, uint64_t>> pairs_ab;
+    size_t n_params = 0;
+    Index rep_stride = 0;
+    std::vector<std::vector<size_t>> occupations_a;
+    std::vector<std::vector<size_t>> occupations_b;
+    CachedOrbitalRotation::IndexCache cache_a, cache_b;
+
+    /// Operators of each repetition, built on first use after a change
+    std::vector<std::optional<RepOperators>> operators;
+    std::optional<CachedOrbitalRotation> final_rotation;
+
+    size_t capacity = 0; ///< Number of checkpoints that fit in the budget
+    /// State after each repetition, if kept
+    std::vector<std::optional<MatrixXcd>> checkpoints;
+    VectorXcd last_params;
+    Stats counters;
+};
+
+} // namespace ffsim
+
+#endif // UCJ_CHECKPOINT_HPP
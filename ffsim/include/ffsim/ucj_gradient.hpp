@@ -0,0 +1,324 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef UCJ_GRADIENT_HPP
+#define UCJ_GRADIENT_HPP
+
+#include "gates/diag_coulomb.hpp"
+#include "gates/orbital_rotation.hpp"
+#include "linalg/expm.hpp"
+#include "molecular_hamiltonian.hpp"
+#include "states.hpp"
+#include "trotter.hpp"
+#include "ucjop_spinbalanced.hpp"
+#include "utils.hpp"
+#include <Eigen/Dense>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ffsim
+{
+
+using namespace Eigen;
+using namespace gates;
+
+/**
+ * @brief Computes the one-body transition density <bra| E_pq |ket>.
+ *
+ * @param bra Reshaped bra state (alpha strings in rows)
+ * @param ket Reshaped ket state (alpha strings in rows)
+ * @param norb Number of spatial orbitals
+ * @param table_a Single-excitation table of the alpha strings
+ * @param table_b Single-excitation table of the beta strings
+ * @return The `norb x norb` transition density
+ */
+MatrixXcd transition_rdm1(
+    const MatrixXcd &bra, const MatrixXcd &ket, uint64_t norb,
+    const std::vector<SingleExcitation> &table_a,
+    const std::vector<SingleExcitation> &table_b
+)
+{
+    const auto n = static_cast<Index>(norb);
+    const Index dim_a = bra.rows();
+    const Index dim_b = bra.cols();
+    const size_t stride_a = table_a.size() / static_cast<size_t>(dim_a);
+    const size_t stride_b = table_b.size() / static_cast<size_t>(dim_b);
+    // Alpha excitations pair rows, which are contiguous in the transposes.
+    const MatrixXcd bra_t = bra.transpose();
+    const MatrixXcd ket_t = ket.transpose();
+
+    VectorXcd rdm = VectorXcd::Zero(n * n);
+#pragma omp parallel
+    {
+        VectorXcd local = VectorXcd::Zero(n * n);
+#pragma omp for schedule(static) nowait
+        for (Index ia = 0; ia < dim_a; ++ia) {
+            for (size_t k = ia * stride_a; k < (ia + 1) * stride_a; ++k) {
+                const auto &e = table_a[k];
+                local(e.orbital_pair) +=
+                    e.sign * bra_t.col(ia).dot(ket_t.col(e.target));
+            }
+        }
+#pragma omp for schedule(static) nowait
+        for (Index ib = 0; ib < dim_b; ++ib) {
+            for (size_t k = ib * stride_b; k < (ib + 1) * stride_b; ++k) {
+                const auto &e = table_b[k];
+                local(e.orbital_pair) += e.sign * bra.col(ib).dot(ket.col(e.target));
+            }
+        }
+#pragma omp critical
+        rdm += local;
+    }
+
+    MatrixXcd result(n, n);
+    for (Index p = 0; p < n; ++p) {
+        for (Index q = 0; q < n; ++q) {
+            result(p, q) = rdm(p * n + q);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Maps the gradient with respect to an orbital rotation generator to the
+ * parameters of orbital_rotation_from_parameters.
+ *
+ * @param generator_gradient G with dE = 2 Re sum_ij G_ij dK_ij
+ * @param norb Number of spatial orbitals
+ * @return Gradient with respect to the norb^2 (complex) rotation parameters
+ */
+VectorXd
+orbital_rotation_parameters_gradient(const MatrixXcd &generator_gradient, int norb)
+{
+    const MatrixXcd &g = generator_gradient;
+    const Index n_triu_no_diag = norb * (norb - 1) / 2;
+    VectorXd gradient(norb * norb);
+    Index real_index = 0;
+    Index imag_index = n_triu_no_diag;
+    for (Index i = 0; i < norb; ++i) {
+        gradient(imag_index++) = -2.0 * g(i, i).imag();
+        for (Index j = i + 1; j < norb; ++j) {
+            gradient(real_index++) = 2.0 * (g(i, j) - g(j, i)).real();
+            gradient(imag_index++) = -2.0 * (g(i, j) + g(j, i)).imag();
+        }
+    }
+    return gradient;
+}
+
+/**
+ * @brief Computes the energy of the LUCJ state and its gradient with respect to
+ * the UCJ parameters by the adjoint method.
+ *
+ * The state is prepared from Hartree-Fock with the operator given by
+ * UCJOpSpinBalanced::from_parameters. After one forward pass and one
+ * application of the Hamiltonian, both the state and H|psi> are propagated
+ * backwards through the gates. The gradient of each diagonal Coulomb evolution
+ * follows from the phases it applies; that of each orbital rotation from the
+ * transition density of the two states and the Frechet derivative of expm. The
+ * Givens decompositions of the forward pass are reused for the inverse gates,
+ * so the full gradient costs about three energy evaluations.
+ *
+ * @param params Real-valued parameter vector
+ * @param norb Number of orbitals
+ * @param nelec (alpha, beta) electron counts
+ * @param n_reps Number of repetitions
+ * @param interaction_pairs Optional interaction masks
+ * @param with_final_orbital_rotation Whether to include the final orbital
+ * rotation
+ * @param hamiltonian The molecular Hamiltonian
+ * @return The energy and its gradient with respect to `params`
+ */
+std::pair<double, VectorXd> ucj_energy_and_gradient(
+    const VectorXcd &params, uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec,
+    size_t n_reps,
+    const std::array<std::optional<std::vector<std::pair<uint64_t, uint64_t>>>, 2>
+        &interaction_pairs,
+    bool with_final_orbital_rotation, const MolecularHamiltonian &hamiltonian
+)
+{
+    auto expected_params = UCJOpSpinBalanced::n_params(
+        norb, n_reps, interaction_pairs, with_final_orbital_rotation
+    );
+    if (static_cast<size_t>(params.size()) != expected_params) {
+        throw std::runtime_error(
+            "Expected " + std::to_string(expected_params) + " parameters, but got " +
+            std::to_string(params.size())
+        );
+    }
+    if (dim(norb, nelec) != hamiltonian.dim()) {
+        throw std::invalid_argument("Hamiltonian and nelec do not match");
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> triu;
+    for (size_t i = 0; i < norb; ++i) {
+        for (size_t j = i; j < norb; ++j) {
+            triu.emplace_back(i, j);
+        }
+    }
+    const auto &pairs_aa = interaction_pairs[0].value_or(triu);
+    const auto &pairs_ab = interaction_pairs[1].value_or(triu);
+    const auto n = static_cast<Index>(norb);
+    const Index n_rot = n * n;
+    const auto n_aa = static_cast<Index>(pairs_aa.size());
+    const auto n_ab = static_cast<Index>(pairs_ab.size());
+    const Index rep_stride = n_rot + n_aa + n_ab;
+
+    // Gates of the forward pass and their inverses.
+    std::vector<MatrixXcd> generators;
+    std::vector<MatrixXcd> rotations;
+    std::vector<CachedOrbitalRotation> cached_rotations;
+    std::vector<CachedOrbitalRotation> cached_inverses;
+    std::vector<MatExp> mat_exps;
+    std::vector<MatExp> inverse_mat_exps;
+    const size_t n_rotations = n_reps + (with_final_orbital_rotation ? 1 : 0);
+    for (size_t k = 0; k < n_rotations; ++k) {
+        MatrixXcd generator = orbital_rotation_generator_from_parameters(
+            params.segment(static_cast<Index>(k) * rep_stride, n_rot),
+            static_cast<int>(norb), false
+        );
+        MatrixXcd rotation = linalg::expm(generator);
+        cached_rotations.emplace_back(rotation, norb);
+        cached_inverses.emplace_back(rotation.adjoint(), norb);
+        generators.push_back(std::move(generator));
+        rotations.push_back(std::move(rotation));
+    }
+    for (size_t rep = 0; rep < n_reps; ++rep) {
+        Index index = static_cast<Index>(rep) * rep_stride + n_rot;
+        MatrixXcd mat_aa = MatrixXcd::Zero(n, n);
+        MatrixXcd mat_ab = MatrixXcd::Zero(n, n);
+        for (const auto &[i, j] : pairs_aa) {
+            mat_aa(i, j) = mat_aa(j, i) = params(index++);
+        }
+        for (const auto &[i, j] : pairs_ab) {
+            mat_ab(i, j) = mat_ab(j, i) = params(index++);
+        }
+        Mat mat{MatType::Triple, MatrixXcd(), {mat_aa, mat_ab, mat_aa}};
+        mat_exps.push_back(get_mat_exp(mat, norb, false, -1.0));
+        inverse_mat_exps.push_back(get_mat_exp(mat, norb, false, 1.0));
+    }
+
+    const size_t n_alpha = nelec.first;
+    const size_t n_beta = nelec.second;
+    std::vector<size_t> orb_list(norb);
+    std::iota(orb_list.begin(), orb_list.end(), 0);
+    auto occupations_a = gen_occslst(orb_list, n_alpha);
+    auto occupations_b = gen_occslst(orb_list, n_beta);
+    auto table_a = single_excitation_table(norb, n_alpha);
+    auto table_b = single_excitation_table(norb, n_beta);
+
+    const auto dim_a = static_cast<Index>(occupations_a.size());
+    const auto dim_b = static_cast<Index>(occupations_b.size());
+    MatrixXd number_a = MatrixXd::Zero(dim_a, n);
+    MatrixXd number_b = MatrixXd::Zero(dim_b, n);
+    for (Index i = 0; i < dim_a; ++i) {
+        for (auto orb : occupations_a[i]) {
+            number_a(i, static_cast<Index>(orb)) = 1.0;
+        }
+    }
+    for (Index i = 0; i < dim_b; ++i) {
+        for (auto orb : occupations_b[i]) {
+            number_b(i, static_cast<Index>(orb)) = 1.0;
+        }
+    }
+
+    CachedOrbitalRotation::IndexCache cache_a, cache_b;
+    auto rotate = [&](MatrixXcd &vec, const CachedOrbitalRotation &rotation) {
+        rotation.apply(vec, n_alpha, cache_a);
+        MatrixXcd transposed = vec.transpose();
+        rotation.apply(transposed, n_beta, n_alpha == n_beta ? cache_a : cache_b);
+        vec = transposed.transpose();
+    };
+
+    // Forward pass.
+    MatrixXcd state = MatrixXcd::Zero(dim_a, dim_b);
+    state(0, 0) = 1.0;
+    for (size_t rep = 0; rep < n_reps; ++rep) {
+        rotate(state, cached_inverses[rep]);
+        apply_diag_coulomb_evolution_in_place_num_rep(
+            state, norb, mat_exps[rep], occupations_a, occupations_b
+        );
+        rotate(state, cached_rotations[rep]);
+    }
+    if (with_final_orbital_rotation) {
+        rotate(state, cached_rotations[n_reps]);
+    }
+
+    VectorXcd psi = Map<VectorXcd>(state.data(), dim_a * dim_b);
+    VectorXcd h_psi = hamiltonian.apply(psi);
+    const double energy = psi.dot(h_psi).real();
+    MatrixXcd adjoint = Map<MatrixXcd>(h_psi.data(), dim_a, dim_b);
+
+    // dE/dK for the gate W(expm(generator)), given the states after the gate.
+    auto generator_gradient = [&](const MatrixXcd &generator,
+                                  const MatrixXcd &rotation) -> MatrixXcd {
+        MatrixXcd rdm = transition_rdm1(adjoint, state, norb, table_a, table_b);
+        return linalg::expm_frechet(generator.transpose(), rdm * rotation.conjugate());
+    };
+
+    // Backward pass.
+    VectorXd gradient = VectorXd::Zero(params.size());
+    if (with_final_orbital_rotation) {
+        MatrixXcd g = generator_gradient(generators[n_reps], rotations[n_reps]);
+        gradient.segment(static_cast<Index>(n_reps) * rep_stride, n_rot) =
+            orbital_rotation_parameters_gradient(g, static_cast<int>(norb));
+        rotate(state, cached_inverses[n_reps]);
+        rotate(adjoint, cached_inverses[n_reps]);
+    }
+    for (size_t rep = n_reps; rep-- > 0;) {
+        const Index offset = static_cast<Index>(rep) * rep_stride;
+        MatrixXcd g = generator_gradient(generators[rep], rotations[rep]);
+        rotate(state, cached_inverses[rep]);
+        rotate(adjoint, cached_inverses[rep]);
+
+        // The evolution multiplies each determinant by exp(i phi), phi linear
+        // in the parameters, so dE/dtheta = -2 Im sum conj(adjoint) dphi state.
+        MatrixXcd weights = adjoint.conjugate().cwiseProduct(state);
+        VectorXcd weights_a = weights.rowwise().sum();
+        VectorXcd weights_b = weights.colwise().sum().transpose();
+        MatrixXcd pair_ab = number_a.transpose() * weights * number_b;
+        MatrixXcd pair_aa = number_a.transpose() * weights_a.asDiagonal() * number_a +
+                            number_b.transpose() * weights_b.asDiagonal() * number_b;
+        Index index = offset + n_rot;
+        for (const auto &[i, j] : pairs_aa) {
+            Complex value = i == j ? 0.5 * pair_aa(i, i) : pair_aa(i, j);
+            gradient(index++) = -2.0 * value.imag();
+        }
+        for (const auto &[i, j] : pairs_ab) {
+            Complex value = i == j ? pair_ab(i, i) : pair_ab(i, j) + pair_ab(j, i);
+            gradient(index++) = -2.0 * value.imag();
+        }
+        apply_diag_coulomb_evolution_in_place_num_rep(
+            state, norb, inverse_mat_exps[rep], occupations_a, occupations_b
+        );
+        apply_diag_coulomb_evolution_in_place_num_rep(
+            adjoint, norb, inverse_mat_exps[rep], occupations_a, occupations_b
+        );
+
+        // The first gate of the repetition is W(expm(-K)).
+        g -= generator_gradient(-generators[rep], rotations[rep].adjoint());
+        gradient.segment(offset, n_rot) =
+            orbital_rotation_parameters_gradient(g, static_cast<int>(norb));
+        rotate(state, cached_rotations[rep]);
+        rotate(adjoint, cached_rotations[rep]);
+    }
+
+    return {energy, gradient};
+}
+
+} // namespace ffsim
+
+#endif // UCJ_GRADIENT_HPP
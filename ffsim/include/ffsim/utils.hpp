@@ -90,16 +90,17 @@ VectorXd orbital_rotation_to_parameters(const MatrixXcd &orbital_rotation, bool
 };
 
 /**
- * @brief Converts a vector of parameters to an orbital rotation matrix.
- * @details This function takes a vector of parameters and converts it to an
- * orbital rotation matrix.
+ * @brief Converts a vector of parameters to the anti-Hermitian generator of an
+ * orbital rotation.
+ * @details The orbital rotation is the matrix exponential of the generator.
  * @param params The input vector of parameters.
  * @param norb The number of orbitals.
  * @param real A boolean indicating whether the matrix is real (true) or complex
  * (false).
- * @return The resulting orbital rotation matrix.
+ * @return The generator K with orbital rotation expm(K).
  */
-MatrixXcd orbital_rotation_from_parameters(const VectorXcd &params, int norb, bool real)
+MatrixXcd
+orbital_rotation_generator_from_parameters(const VectorXcd &params, int norb, bool real)
 {
     std::vector<std::pair<uint64_t, uint64_t>> triu_indices_no_diag;
     for (int i = 0; i < norb; ++i) {
@@ -135,7 +136,22 @@ MatrixXcd orbital_rotation_from_parameters(const VectorXcd &params, int norb, bo
         generator(static_cast<Index>(j), static_cast<Index>(i)) -=
             Complex(param_val.real(), 0.0);
     }
-    return linalg::expm(generator);
+    return generator;
+}
+
+/**
+ * @brief Converts a vector of parameters to an orbital rotation matrix.
+ * @details This function takes a vector of parameters and converts it to an
+ * orbital rotation matrix.
+ * @param params The input vector of parameters.
+ * @param norb The number of orbitals.
+ * @param real A boolean indicating whether the matrix is real (true) or complex
+ * (false).
+ * @return The resulting orbital rotation matrix.
+ */
+MatrixXcd orbital_rotation_from_parameters(const VectorXcd &params, int norb, bool real)
+{
+    return linalg::expm(orbital_rotation_generator_from_parameters(params, norb, real));
 };
 
 /**
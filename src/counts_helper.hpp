@@ -0,0 +1,355 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef COUNTS_HELPER_HPP_
+#define COUNTS_HELPER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/dynamic_bitset.hpp"
+
+// Settings of the bounded-memory counts mode.
+struct StreamingCounts {
+    // Number of distinct bitstrings kept; 0 keeps the full histogram.
+    uint64_t capacity = 0;
+    // Shots per sampler job, so that only one job's histogram is held at a time.
+    uint64_t chunk_shots = 1000000;
+
+    bool enabled() const
+    {
+        return capacity > 0;
+    }
+};
+
+// Approximate counts of the most frequent bitstrings of a shot stream, in memory
+// bounded by the capacity (Space-Saving, Metwally, Agrawal, El Abbadi, ICDT 2005).
+//
+// A new bitstring arriving when the summary is full replaces the one with the
+// smallest count and inherits that count as its error. Every bitstring with a
+// true count above total() / capacity is guaranteed to be kept, and a kept count
+// overestimates the true count by at most its error.
+class HeavyHitterCounts
+{
+  public:
+    explicit HeavyHitterCounts(uint64_t capacity) : capacity_(capacity)
+    {
+        entries_.reserve(capacity);
+    }
+
+    // Adds weight shots of a bitstring.
+    void add(const std::string &bitstring, uint64_t weight = 1)
+    {
+        total_ += weight;
+        auto it = entries_.find(bitstring);
+        if (it != entries_.end()) {
+            order_.erase({it->second.count, &it->first});
+            it->second.count += weight;
+            order_.insert({it->second.count, &it->first});
+            return;
+        }
+        Entry entry{weight, 0};
+        if (entries_.size() >= capacity_) {
+            auto smallest = order_.begin();
+            entry = {smallest->first + weight, smallest->first};
+            // Erasing by key would pass a reference to the key being destroyed.
+            auto evicted = entries_.find(*smallest->second);
+            order_.erase(smallest);
+            entries_.erase(evicted);
+        }
+        it = entries_.emplace(bitstring, entry).first;
+        order_.insert({entry.count, &it->first});
+    }
+
+    // Adds a histogram, e.g. the counts of one sampler job.
+    void add(const std::unordered_map<std::string, uint64_t> &counts)
+    {
+        for (const auto &[bitstring, count] : counts) {
+            add(bitstring, count);
+        }
+    }
+
+    // Guaranteed counts (count - error) of the kept bitstrings, dropping those
+    // whose whole count may come from evicted bitstrings.
+    std::unordered_map<std::string, uint64_t> counts() const
+    {
+        std::unordered_map<std::string, uint64_t> heavy;
+        for (const auto &[bitstring, entry] : entries_) {
+            if (entry.count > entry.error) {
+                heavy.emplace(bitstring, entry.count - entry.error);
+            }
+        }
+        return heavy;
+    }
+
+    // Number of shots added.
+    uint64_t total() const
+    {
+        return total_;
+    }
+
+    // Shots not attributed to a kept bitstring by counts(), the aggregate of the
+    // tail of the distribution.
+    uint64_t tail_count() const
+    {
+        uint64_t guaranteed = 0;
+        for (const auto &[bitstring, entry] : entries_) {
+            guaranteed += entry.count - entry.error;
+        }
+        return total_ - guaranteed;
+    }
+
+    // Upper bound on the overestimate of any count, the smallest kept count once
+    // the summary is full.
+    uint64_t max_error() const
+    {
+        return entries_.size() < capacity_ || order_.empty() ? 0
+                                                             : order_.begin()->first;
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+  private:
+    struct Entry {
+        uint64_t count;
+        uint64_t error;
+    };
+
+    uint64_t capacity_;
+    uint64_t total_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+    // Kept bitstrings by count; keys of entries_ do not move on rehash.
+    std::set<std::pair<uint64_t, const std::string *>> order_;
+};
+
+// Histogram of shots kept as packed bit words, qubit q at bit q % 64 of word
+// q / 64, in an open-addressing table keyed by the words themselves. Shots that
+// arrive packed are counted without ever becoming strings, and the arrays for
+// recovery are built from whole blocks.
+class PackedCounts
+{
+  public:
+    explicit PackedCounts(size_t num_bits)
+      : num_bits_(num_bits), words_((num_bits + 63) / 64), slots_(64, empty)
+    {
+    }
+
+    // Adds count shots of one packed bitstring of words() words; zero counts are
+    // ignored.
+    void add(const uint64_t *shot, uint64_t count = 1)
+    {
+        if (count == 0) {
+            return;
+        }
+        total_ += count;
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash(shot) & mask;; slot = (slot + 1) & mask) {
+            if (slots_[slot] == empty) {
+                slots_[slot] = counts_.size();
+                keys_.insert(keys_.end(), shot, shot + words_);
+                counts_.push_back(count);
+                if (2 * counts_.size() > slots_.size()) {
+                    grow();
+                }
+                return;
+            }
+            if (std::equal(shot, shot + words_, &keys_[slots_[slot] * words_])) {
+                counts_[slots_[slot]] += count;
+                return;
+            }
+        }
+    }
+
+    // Adds consecutive packed shots, words() words each.
+    void add_shots(const std::vector<uint64_t> &shots)
+    {
+        for (size_t offset = 0; offset + words_ <= shots.size(); offset += words_) {
+            add(&shots[offset]);
+        }
+    }
+
+    // Adds count shots of a bitstring in Qiskit order, qubit q at character
+    // num_bits - 1 - q.
+    void add(const std::string &bitstring, uint64_t count = 1)
+    {
+        scratch_.assign(words_, 0);
+        for (size_t q = 0; q < num_bits_; ++q) {
+            if (bitstring[num_bits_ - 1 - q] == '1') {
+                scratch_[q / 64] |= 1ULL << (q % 64);
+            }
+        }
+        add(scratch_.data(), count);
+    }
+
+    // Adds a string histogram such as the counts of a sampler job.
+    void add(const std::unordered_map<std::string, uint64_t> &counts)
+    {
+        for (const auto &[bitstring, count] : counts) {
+            add(bitstring, count);
+        }
+    }
+
+    // Distinct bitstrings as bitsets (bit q is qubit q) with their frequencies,
+    // in first-seen order; empty arrays if no shot was added.
+    std::pair<std::vector<boost::dynamic_bitset<>>, std::vector<double>>
+    to_arrays() const
+    {
+        if (total_ == 0) {
+            return {};
+        }
+        static_assert(
+            sizeof(boost::dynamic_bitset<>::block_type) == sizeof(uint64_t),
+            "bitset blocks must be 64-bit words"
+        );
+        std::vector<boost::dynamic_bitset<>> bitstrings(
+            counts_.size(), boost::dynamic_bitset<>(num_bits_)
+        );
+        std::vector<double> probabilities(counts_.size());
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            const uint64_t *key = &keys_[i * words_];
+            boost::from_block_range(key, key + words_, bitstrings[i]);
+            probabilities[i] =
+                static_cast<double>(counts_[i]) / static_cast<double>(total_);
+        }
+        return {bitstrings, probabilities};
+    }
+
+    // The same histogram keyed by bitstrings in Qiskit order, for consumers of
+    // sampler counts.
+    std::unordered_map<std::string, uint64_t> to_counts() const
+    {
+        std::unordered_map<std::string, uint64_t> counts;
+        counts.reserve(counts_.size());
+        std::string bitstring(num_bits_, '0');
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            const uint64_t *key = &keys_[i * words_];
+            for (size_t q = 0; q < num_bits_; ++q) {
+                const bool set = (key[q / 64] >> (q % 64)) & 1;
+                bitstring[num_bits_ - 1 - q] = set ? '1' : '0';
+            }
+            counts.emplace(bitstring, counts_[i]);
+        }
+        return counts;
+    }
+
+    // Packed distinct bitstrings, words() words each, in first-seen order.
+    const std::vector<uint64_t> &keys() const
+    {
+        return keys_;
+    }
+
+    // Shots of each distinct bitstring, in the order of keys().
+    const std::vector<uint64_t> &key_counts() const
+    {
+        return counts_;
+    }
+
+    size_t num_bits() const
+    {
+        return num_bits_;
+    }
+
+    size_t words() const
+    {
+        return words_;
+    }
+
+    size_t size() const
+    {
+        return counts_.size();
+    }
+
+    uint64_t total() const
+    {
+        return total_;
+    }
+
+  private:
+    static constexpr size_t empty = ~size_t(0);
+
+    size_t hash(const uint64_t *shot) const
+    {
+        uint64_t h = 0x9e3779b97f4a7c15ULL;
+        for (size_t w = 0; w < words_; ++w) {
+            // splitmix64 finalizer over each word
+            uint64_t x = h ^ shot[w];
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            h = x ^ (x >> 31);
+        }
+        return static_cast<size_t>(h);
+    }
+
+    void grow()
+    {
+        std::vector<size_t> slots(2 * slots_.size(), empty);
+        size_t mask = slots.size() - 1;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            size_t slot = hash(&keys_[i * words_]) & mask;
+            while (slots[slot] != empty) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = i;
+        }
+        slots_.swap(slots);
+    }
+
+    size_t num_bits_;
+    size_t words_;
+    uint64_t total_ = 0;
+    std::vector<uint64_t> keys_;   // words() words per distinct bitstring
+    std::vector<uint64_t> counts_; // shots per distinct bitstring
+    std::vector<size_t> slots_;    // indices into counts_, power-of-two size
+    std::vector<uint64_t> scratch_;
+};
+
+// Whether a sampler bit array exposes its shots as packed words through
+// packed_words(): shot s in words [s * w, (s + 1) * w) with w = (num_bits + 63) /
+// 64, qubit q at bit q % 64 of word q / 64.
+template <typename BitArray, typename = void>
+struct has_packed_words : std::false_type {
+};
+
+template <typename BitArray>
+struct has_packed_words<
+    BitArray, std::void_t<decltype(std::declval<BitArray &>().packed_words())>>
+  : std::true_type {
+};
+
+// Adds the shots of a sampler bit array. Its packed words are counted directly
+// when it has packed_words(); otherwise the shots arrive as the string
+// histogram of get_counts() and are packed here.
+template <typename BitArray> void add_bit_array(PackedCounts &counts, BitArray &&bits)
+{
+    if constexpr (has_packed_words<std::remove_reference_t<BitArray>>::value) {
+        const auto &words = bits.packed_words();
+        for (size_t offset = 0; offset + counts.words() <= words.size();
+             offset += counts.words()) {
+            counts.add(&words[offset]);
+        }
+    } else {
+        counts.add(bits.get_counts());
+    }
+}
+
+#endif // COUNTS_HELPER_HPP_
@@ -0,0 +1,258 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef DAVIDSON_HELPER_HPP_
+#define DAVIDSON_HELPER_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "mpi.h"
+
+// Lowest eigenpairs found by block_davidson. Vectors are the local slices.
+struct BlockDavidsonResult {
+    std::vector<double> energies;
+    std::vector<std::vector<double>> vectors;
+    std::vector<double> residuals;
+    int iterations = 0;
+    bool converged = false;
+};
+
+// Excited states returned by sbd_main next to the ground state, root 1 first.
+// Empty unless more than one root is requested.
+struct ExcitedStates {
+    std::vector<double> energies;
+    std::vector<std::vector<double>> densities; // interleaved alpha/beta per root
+};
+
+namespace davidson
+{
+
+// Local part of V^T W, summed over comm.
+inline Eigen::MatrixXd
+gram(const Eigen::MatrixXd &V, const Eigen::MatrixXd &W, MPI_Comm comm)
+{
+    Eigen::MatrixXd local = V.transpose() * W;
+    Eigen::MatrixXd global(local.rows(), local.cols());
+    MPI_Allreduce(
+        local.data(), global.data(), static_cast<int>(local.size()), MPI_DOUBLE,
+        MPI_SUM, comm
+    );
+    return global;
+}
+
+// Length of the vector split over comm.
+inline int64_t global_size(size_t local_size, MPI_Comm comm)
+{
+    auto size = static_cast<int64_t>(local_size);
+    MPI_Allreduce(MPI_IN_PLACE, &size, 1, MPI_INT64_T, MPI_SUM, comm);
+    return size;
+}
+
+} // namespace davidson
+
+// Unit vectors on the num_roots lowest diagonal elements over all ranks of comm,
+// the starting block of block_davidson; fewer if the dimension is smaller.
+std::vector<std::vector<double>> lowest_diagonal_guesses(
+    const std::vector<double> &diagonal, int num_roots, MPI_Comm comm
+)
+{
+    num_roots = static_cast<int>(std::min<int64_t>(
+        num_roots, davidson::global_size(diagonal.size(), comm)
+    ));
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    std::vector<size_t> order(diagonal.size());
+    std::iota(order.begin(), order.end(), 0);
+    const size_t local_count = std::min(order.size(), static_cast<size_t>(num_roots));
+    std::partial_sort(
+        order.begin(), order.begin() + static_cast<std::ptrdiff_t>(local_count),
+        order.end(), [&](size_t a, size_t b) { return diagonal[a] < diagonal[b]; }
+    );
+    // Candidates padded to num_roots entries per rank, empty slots at +inf.
+    std::vector<double> values(num_roots, HUGE_VAL);
+    for (size_t k = 0; k < local_count; ++k) {
+        values[k] = diagonal[order[k]];
+    }
+    std::vector<double> all(static_cast<size_t>(num_roots) * size);
+    MPI_Allgather(
+        values.data(), num_roots, MPI_DOUBLE, all.data(), num_roots, MPI_DOUBLE, comm
+    );
+    std::vector<size_t> picks(all.size());
+    std::iota(picks.begin(), picks.end(), 0);
+    std::stable_sort(picks.begin(), picks.end(), [&](size_t a, size_t b) {
+        return all[a] < all[b];
+    });
+    std::vector<std::vector<double>> guesses(
+        num_roots, std::vector<double>(diagonal.size(), 0.0)
+    );
+    for (int root = 0; root < num_roots; ++root) {
+        size_t pick = picks[root];
+        if (static_cast<int>(pick / num_roots) == rank) {
+            guesses[root][order[pick % num_roots]] = 1.0;
+        }
+    }
+    return guesses;
+}
+
+// Lowest num_roots eigenpairs of a real symmetric operator by block Davidson
+// (Liu's variant), all roots sharing one subspace.
+//
+// Every iteration applies the operator once to each new correction vector and
+// updates the Rayleigh-Ritz problem of the whole block; corrections are
+// Olsen's diagonally preconditioned residuals of the unconverged roots. When
+// the subspace would exceed max_subspace vectors it restarts from the lowest
+// 2 * num_roots Ritz vectors. A root is converged once its residual norm is
+// below sqrt(eps), which bounds its energy error by about eps.
+//
+// The subspace starts from the guesses, of which there may be more than
+// num_roots; num_roots is capped at the dimension of the problem.
+//
+// apply(x, y) must set y = H x for local slices x and y. Inner products are
+// reduced over comm, the communicator that splits the vector, and every stop
+// decision is taken jointly so that all ranks leave the loop together.
+template <typename Apply>
+BlockDavidsonResult block_davidson(
+    const std::vector<double> &diagonal,
+    const std::vector<std::vector<double>> &guesses, int num_roots_requested,
+    Apply &&apply, MPI_Comm comm, int max_iterations, int max_subspace, double eps,
+    double max_time
+)
+{
+    using Eigen::Index;
+    using Eigen::MatrixXd;
+    using Eigen::VectorXd;
+
+    const auto n = static_cast<Index>(diagonal.size());
+    const auto num_roots = static_cast<Index>(std::min<int64_t>(
+        num_roots_requested, davidson::global_size(diagonal.size(), comm)
+    ));
+    const Index capacity = std::max<Index>(
+        {max_subspace, 3 * num_roots, static_cast<Index>(guesses.size())}
+    );
+    const double tol = std::sqrt(eps);
+    const auto time_start = std::chrono::high_resolution_clock::now();
+    Eigen::Map<const VectorXd> diag(diagonal.data(), n);
+
+    MatrixXd V(n, capacity);
+    MatrixXd AV(n, capacity);
+    std::vector<double> x(n), y(n);
+    Index m = 0;
+
+    // Orthonormalizes the candidate against V (twice, for stability) and adds it
+    // with its image under the operator, unless it is numerically dependent.
+    auto extend = [&](VectorXd candidate) {
+        for (int pass = 0; pass < 2 && m > 0; ++pass) {
+            VectorXd overlaps = davidson::gram(V.leftCols(m), candidate, comm);
+            candidate.noalias() -= V.leftCols(m) * overlaps;
+        }
+        double norm = std::sqrt(davidson::gram(candidate, candidate, comm)(0, 0));
+        if (norm < 1.0e-10) {
+            return false;
+        }
+        V.col(m) = candidate / norm;
+        VectorXd::Map(x.data(), n) = V.col(m);
+        std::fill(y.begin(), y.end(), 0.0);
+        apply(x, y);
+        AV.col(m) = VectorXd::Map(y.data(), n);
+        ++m;
+        return true;
+    };
+
+    for (const auto &guess : guesses) {
+        extend(VectorXd::Map(guess.data(), n));
+    }
+
+    BlockDavidsonResult result;
+    VectorXd theta;
+    MatrixXd ritz, ritz_images;
+    for (result.iterations = 0;; ++result.iterations) {
+        Eigen::SelfAdjointEigenSolver<MatrixXd> solver(
+            davidson::gram(V.leftCols(m), AV.leftCols(m), comm)
+                .selfadjointView<Eigen::Upper>()
+        );
+        // Ritz pairs of the roots, followed by as many more to keep on restart.
+        const Index k = std::min(num_roots, m);
+        const Index kept = std::min(2 * num_roots, m);
+        theta = solver.eigenvalues().head(k);
+        ritz = V.leftCols(m) * solver.eigenvectors().leftCols(kept);
+        ritz_images = AV.leftCols(m) * solver.eigenvectors().leftCols(kept);
+
+        MatrixXd residuals =
+            ritz_images.leftCols(k) - ritz.leftCols(k) * theta.asDiagonal();
+        VectorXd norms =
+            davidson::gram(residuals, residuals, comm).diagonal().cwiseSqrt();
+        result.residuals.assign(norms.data(), norms.data() + k);
+        result.converged = k == num_roots && (norms.array() < tol).all();
+
+        // The slowest rank's clock decides, so that no rank stops alone.
+        double elapsed = std::chrono::duration<double>(
+                             std::chrono::high_resolution_clock::now() - time_start
+        )
+                             .count();
+        MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, comm);
+        if (result.converged || result.iterations >= max_iterations ||
+            elapsed > max_time) {
+            break;
+        }
+
+        // Thick restart from the lowest Ritz vectors when the corrections would
+        // not fit.
+        if (m + k > capacity) {
+            V.leftCols(kept) = ritz;
+            AV.leftCols(kept) = ritz_images;
+            m = kept;
+        }
+        bool grown = false;
+        for (Index root = 0; root < k; ++root) {
+            if (norms(root) < tol || m == capacity) {
+                continue;
+            }
+            // Olsen's correction: the preconditioned residual minus the
+            // preconditioned Ritz vector, scaled so that the update stays
+            // orthogonal to the Ritz vector in the preconditioner's metric.
+            VectorXd inverse = (diag.array() - theta(root)).unaryExpr([](double d) {
+                return 1.0 / (std::abs(d) < 1.0e-8 ? (d < 0.0 ? -1.0e-8 : 1.0e-8) : d);
+            });
+            VectorXd scaled_residual = inverse.cwiseProduct(residuals.col(root));
+            VectorXd scaled_ritz = inverse.cwiseProduct(ritz.col(root));
+            Eigen::Vector2d local(
+                ritz.col(root).dot(scaled_residual), ritz.col(root).dot(scaled_ritz)
+            );
+            Eigen::Vector2d global;
+            MPI_Allreduce(local.data(), global.data(), 2, MPI_DOUBLE, MPI_SUM, comm);
+            VectorXd correction =
+                scaled_ritz * (global(0) / global(1)) - scaled_residual;
+            grown = extend(std::move(correction)) || grown;
+        }
+        if (!grown) {
+            break;
+        }
+    }
+
+    result.energies.assign(theta.data(), theta.data() + theta.size());
+    for (Index root = 0; root < theta.size(); ++root) {
+        result.vectors.emplace_back(ritz.col(root).data(), ritz.col(root).data() + n);
+    }
+    return result;
+}
+
+#endif // DAVIDSON_HELPER_HPP_
@@ -0,0 +1,193 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef DETERMINANT_INDEX_HELPER_HPP_
+#define DETERMINANT_INDEX_HELPER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Immutable index from determinant strings to their positions in a sorted list.
+//
+// The strings are stored as a static B-tree of nodes of one cache line (8
+// strings, 9 children), numbered like an Eytzinger layout: the children of node
+// k are k * 9 + 1 ... k * 9 + 9, so the tree needs no pointers and the top
+// levels share a few hot cache lines. A lookup reads one node per level, about
+// log_9 n lines where binary search touches log_2 n, and compares the string
+// with a whole node at once in a branchless loop the compiler vectorizes.
+class DeterminantIndex
+{
+  public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    DeterminantIndex() = default;
+
+    // Indexes strings, sorted in increasing order; with repeated strings the
+    // first position is reported.
+    explicit DeterminantIndex(const std::vector<uint64_t> &strings)
+      : size_(strings.size()), nodes_((strings.size() + node_size - 1) / node_size),
+        positions_(nodes_.size() * node_size, npos)
+    {
+        if (!std::is_sorted(strings.begin(), strings.end())) {
+            throw std::invalid_argument("determinant strings must be sorted");
+        }
+        size_t next = 0;
+        fill(strings, 0, next);
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // Position of str in the sorted strings, npos if absent.
+    size_t find(uint64_t str) const
+    {
+        size_t slot = npos;
+        for (size_t k = 0; k < nodes_.size();) {
+            const size_t i = rank(nodes_[k], str);
+            if (i < node_size) {
+                slot = k * node_size + i;
+            }
+            k = child(k, i);
+        }
+        return position(slot, str);
+    }
+
+    bool contains(uint64_t str) const
+    {
+        return find(str) != npos;
+    }
+
+    // Positions of count strings, npos for the absent ones. The strings go
+    // down the tree a group at a time, and the groups are split over the OpenMP
+    // threads when the batch is large enough to pay for them.
+    void find(const uint64_t *strs, size_t count, size_t *positions) const
+    {
+        const auto num_groups =
+            static_cast<int64_t>((count + group_size - 1) / group_size);
+#pragma omp parallel for schedule(static) if (count >= parallel_batch)
+        for (int64_t g = 0; g < num_groups; ++g) {
+            const size_t begin = static_cast<size_t>(g) * group_size;
+            const size_t size = std::min(group_size, count - begin);
+            find_group(strs + begin, size, positions + begin);
+        }
+    }
+
+    std::vector<size_t> find(const std::vector<uint64_t> &strs) const
+    {
+        std::vector<size_t> positions(strs.size());
+        find(strs.data(), strs.size(), positions.data());
+        return positions;
+    }
+
+  private:
+    static constexpr size_t node_size = 8;
+    static constexpr size_t group_size = 16;
+    static constexpr size_t parallel_batch = size_t(1) << 14;
+
+    struct alignas(64) Node {
+        uint64_t keys[node_size];
+    };
+
+    static size_t child(size_t k, size_t i)
+    {
+        return k * (node_size + 1) + i + 1;
+    }
+
+    // Number of keys of node below str.
+    static size_t rank(const Node &node, uint64_t str)
+    {
+        size_t count = 0;
+#pragma omp simd reduction(+ : count)
+        for (size_t i = 0; i < node_size; ++i) {
+            count += node.keys[i] < str ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Position of the string in slot, the first one not below str, if it is str;
+    // padding slots have none.
+    size_t position(size_t slot, uint64_t str) const
+    {
+        if (slot == npos || nodes_[slot / node_size].keys[slot % node_size] != str) {
+            return npos;
+        }
+        return positions_[slot];
+    }
+
+    // Descends the tree for up to group_size strings in lockstep, prefetching
+    // the next node of each, so that the cache misses of one level overlap
+    // instead of following one another.
+    void find_group(const uint64_t *strs, size_t count, size_t *positions) const
+    {
+        size_t node[group_size];
+        size_t slot[group_size];
+        std::fill(node, node + count, 0);
+        std::fill(slot, slot + count, npos);
+        for (bool descending = !nodes_.empty(); descending;) {
+            descending = false;
+            for (size_t j = 0; j < count; ++j) {
+                if (node[j] >= nodes_.size()) {
+                    continue;
+                }
+                const size_t i = rank(nodes_[node[j]], strs[j]);
+                if (i < node_size) {
+                    slot[j] = node[j] * node_size + i;
+                }
+                node[j] = child(node[j], i);
+                if (node[j] < nodes_.size()) {
+                    __builtin_prefetch(&nodes_[node[j]]);
+                    descending = true;
+                }
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            if (slot[j] != npos) {
+                __builtin_prefetch(&positions_[slot[j]]);
+            }
+        }
+        for (size_t j = 0; j < count; ++j) {
+            positions[j] = position(slot[j], strs[j]);
+        }
+    }
+
+    // In-order fill of the subtree of node k; unused slots keep the largest
+    // string so that they sort after every real one.
+    void fill(const std::vector<uint64_t> &strings, size_t k, size_t &next)
+    {
+        if (k >= nodes_.size()) {
+            return;
+        }
+        for (size_t i = 0; i < node_size; ++i) {
+            fill(strings, child(k, i), next);
+            if (next < strings.size()) {
+                nodes_[k].keys[i] = strings[next];
+                positions_[k * node_size + i] = next++;
+            } else {
+                nodes_[k].keys[i] = UINT64_MAX;
+            }
+        }
+        fill(strings, child(k, node_size), next);
+    }
+
+    size_t size_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<size_t> positions_; // position of each slot, npos for padding
+};
+
+#endif // DETERMINANT_INDEX_HELPER_HPP_
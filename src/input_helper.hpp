@@ -0,0 +1,350 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef INPUT_HELPER_HPP_
+#define INPUT_HELPER_HPP_
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "mpi.h"
+
+// All run inputs read from the parameter and occupancy files, in flat arrays.
+// Rank 0 fills it, then it travels to the other ranks as one binary blob.
+struct InputBundle {
+    uint64_t norb = 0;
+    std::vector<uint64_t> nelec;               // (n_alpha, n_beta)
+    std::vector<uint64_t> alpha_alpha_indices; // pairs, flattened
+    std::vector<uint64_t> alpha_beta_indices;  // pairs, flattened
+    std::vector<double> params;                // LUCJ parameters, flattened
+    std::vector<double> occupancies;           // alpha then beta, orbital 0 first
+};
+
+namespace input
+{
+
+constexpr char bundle_magic[8] = {'S', 'Q', 'D', 'I', 'N', 'P', 'U', 'T'};
+constexpr uint64_t bundle_version = 1;
+
+// Streams the numbers of the known top-level keys straight into an InputBundle,
+// flattening nested arrays, without building a JSON document. Other keys are
+// skipped.
+class SaxHandler : public nlohmann::json_sax<nlohmann::json>
+{
+  public:
+    SaxHandler(InputBundle &input, std::set<std::string> &keys)
+      : input_(input), keys_(keys)
+    {
+    }
+
+    bool null() override
+    {
+        return true;
+    }
+    bool boolean(bool) override
+    {
+        return true;
+    }
+    bool number_integer(number_integer_t value) override
+    {
+        if (field_ == "norb" || field_ == "nelec" || field_ == "alpha_alpha_indices" ||
+            field_ == "alpha_beta_indices") {
+            throw std::runtime_error("negative integer in '" + field_ + "'");
+        }
+        return number(static_cast<double>(value));
+    }
+    bool number_unsigned(number_unsigned_t value) override
+    {
+        if (field_ == "norb") {
+            input_.norb = value;
+        } else if (field_ == "nelec") {
+            input_.nelec.push_back(value);
+        } else if (field_ == "alpha_alpha_indices") {
+            input_.alpha_alpha_indices.push_back(value);
+        } else if (field_ == "alpha_beta_indices") {
+            input_.alpha_beta_indices.push_back(value);
+        } else {
+            return number(static_cast<double>(value));
+        }
+        return true;
+    }
+    bool number_float(number_float_t value, const string_t &) override
+    {
+        return number(value);
+    }
+    bool string(string_t &) override
+    {
+        return true;
+    }
+    bool binary(binary_t &) override
+    {
+        return true;
+    }
+    bool start_object(std::size_t) override
+    {
+        ++depth_;
+        return true;
+    }
+    bool end_object() override
+    {
+        --depth_;
+        return true;
+    }
+    bool start_array(std::size_t) override
+    {
+        ++depth_;
+        return true;
+    }
+    bool end_array() override
+    {
+        --depth_;
+        return true;
+    }
+    bool key(string_t &key) override
+    {
+        if (depth_ == 1) {
+            field_ = key;
+            keys_.insert(key);
+        }
+        return true;
+    }
+    bool parse_error(
+        std::size_t position, const std::string &,
+        const nlohmann::detail::exception &ex
+    ) override
+    {
+        throw std::runtime_error(
+            "JSON parse error at byte " + std::to_string(position) + ": " + ex.what()
+        );
+    }
+
+  private:
+    bool number(double value)
+    {
+        if (field_ == "params") {
+            input_.params.push_back(value);
+        } else if (field_ == "init_occupancies") {
+            input_.occupancies.push_back(value);
+        }
+        return true;
+    }
+
+    InputBundle &input_;
+    std::set<std::string> &keys_;
+    std::string field_;
+    int depth_ = 0;
+};
+
+inline void append_bytes(std::vector<char> &blob, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const char *>(data);
+    blob.insert(blob.end(), bytes, bytes + size);
+}
+
+template <typename T>
+void append_array(std::vector<char> &blob, const std::vector<T> &values)
+{
+    uint64_t size = values.size();
+    append_bytes(blob, &size, sizeof(size));
+    append_bytes(blob, values.data(), size * sizeof(T));
+}
+
+// Sequential reader over a packed blob with bounds checks.
+class BlobReader
+{
+  public:
+    explicit BlobReader(const std::vector<char> &blob) : blob_(blob)
+    {
+    }
+
+    void read(void *data, size_t size)
+    {
+        if (size > blob_.size() - offset_) {
+            throw std::runtime_error("truncated input bundle");
+        }
+        std::memcpy(data, blob_.data() + offset_, size);
+        offset_ += size;
+    }
+
+    template <typename T>
+    void read_array(std::vector<T> &values)
+    {
+        uint64_t size = 0;
+        read(&size, sizeof(size));
+        if (size > (blob_.size() - offset_) / sizeof(T)) {
+            throw std::runtime_error("truncated input bundle");
+        }
+        values.resize(size);
+        read(values.data(), size * sizeof(T));
+    }
+
+  private:
+    const std::vector<char> &blob_;
+    size_t offset_ = 0;
+};
+
+} // namespace input
+
+// Parses a JSON input file on the calling rank, appending the known fields to
+// input. Returns the top-level keys present in the file.
+std::set<std::string> load_input_json(const std::string &filename, InputBundle &input)
+{
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    std::set<std::string> keys;
+    input::SaxHandler handler(input, keys);
+    nlohmann::json::sax_parse(file, &handler);
+    return keys;
+}
+
+// Reads the LUCJ parameter file: norb, nelec, the interaction pairs and params.
+void load_parameter_input(const std::string &filename, InputBundle &input)
+{
+    auto keys = load_input_json(filename, input);
+    if (keys.count("norb") == 0) {
+        throw std::runtime_error("'norb' missing in parameter file: " + filename);
+    }
+    if (input.nelec.size() != 2) {
+        throw std::runtime_error("'nelec' must be an array of two integers.");
+    }
+    if (input.alpha_alpha_indices.size() % 2 != 0 ||
+        input.alpha_beta_indices.size() % 2 != 0) {
+        throw std::runtime_error("interaction indices must be pairs: " + filename);
+    }
+}
+
+// Reads the recovery prior, { "init_occupancies": [ alpha..., beta... ] }.
+void load_occupancy_input(const std::string &filename, InputBundle &input)
+{
+    auto keys = load_input_json(filename, input);
+    // Validate input JSON: throw on missing key to fail fast on user error.
+    if (keys.count("init_occupancies") == 0) {
+        throw std::invalid_argument(
+            "no init_occupancies in initial occupancy json: file=" + filename
+        );
+    }
+    if ((input.occupancies.size() & 1) != 0) {
+        throw std::runtime_error(
+            "Initial occupancies list must have even number of elements"
+        );
+    }
+}
+
+// Serializes the bundle: magic, version, norb, then each array as its length
+// followed by the raw values.
+std::vector<char> pack_input(const InputBundle &input)
+{
+    std::vector<char> blob;
+    input::append_bytes(blob, input::bundle_magic, sizeof(input::bundle_magic));
+    input::append_bytes(blob, &input::bundle_version, sizeof(input::bundle_version));
+    input::append_bytes(blob, &input.norb, sizeof(input.norb));
+    input::append_array(blob, input.nelec);
+    input::append_array(blob, input.alpha_alpha_indices);
+    input::append_array(blob, input.alpha_beta_indices);
+    input::append_array(blob, input.params);
+    input::append_array(blob, input.occupancies);
+    return blob;
+}
+
+InputBundle unpack_input(const std::vector<char> &blob)
+{
+    input::BlobReader reader(blob);
+    char magic[sizeof(input::bundle_magic)];
+    uint64_t version = 0;
+    reader.read(magic, sizeof(magic));
+    reader.read(&version, sizeof(version));
+    if (!std::equal(std::begin(magic), std::end(magic), input::bundle_magic) ||
+        version != input::bundle_version) {
+        throw std::runtime_error("not an input bundle of version 1");
+    }
+    InputBundle input;
+    reader.read(&input.norb, sizeof(input.norb));
+    reader.read_array(input.nelec);
+    reader.read_array(input.alpha_alpha_indices);
+    reader.read_array(input.alpha_beta_indices);
+    reader.read_array(input.params);
+    reader.read_array(input.occupancies);
+    return input;
+}
+
+// Pre-converted binary input, written once and read instead of the JSON files.
+void write_input_bundle(const InputBundle &input, const std::string &filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    auto blob = pack_input(input);
+    file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+}
+
+InputBundle read_input_bundle(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + filename);
+    }
+    std::vector<char> blob(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(blob.data(), static_cast<std::streamsize>(blob.size()));
+    return unpack_input(blob);
+}
+
+// Sends the bundle held by root to every rank of comm as one packed blob, in
+// chunks below the int count limit of MPI_Bcast.
+void bcast_input(InputBundle &input, int root, MPI_Comm comm)
+{
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    std::vector<char> blob;
+    if (rank == root) {
+        blob = pack_input(input);
+    }
+    uint64_t size = blob.size();
+    MPI_Bcast(&size, 1, MPI_UINT64_T, root, comm);
+    blob.resize(size);
+    constexpr uint64_t chunk = INT_MAX / 2;
+    for (uint64_t offset = 0; offset < size; offset += chunk) {
+        int count = static_cast<int>(std::min(chunk, size - offset));
+        MPI_Bcast(blob.data() + offset, count, MPI_CHAR, root, comm);
+    }
+    if (rank != root) {
+        input = unpack_input(blob);
+    }
+}
+
+// Interaction pairs from their flattened form.
+std::vector<std::pair<uint64_t, uint64_t>> to_pairs(const std::vector<uint64_t> &flat)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> pairs;
+    pairs.reserve(flat.size() / 2);
+    for (size_t k = 0; k + 1 < flat.size(); k += 2) {
+        pairs.emplace_back(flat[k], flat[k + 1]);
+    }
+    return pairs;
+}
+
+#endif // INPUT_HELPER_HPP_
@@ -16,17 +16,23 @@
 #include <bitset>
 #include <cassert>
 #include <iostream>
-#include <nlohmann/json.hpp>
 #include <random>
 #include <string>
 #include <unordered_map>
 
 #include "boost/dynamic_bitset.hpp"
+#include "ffsim/arena.hpp"
+#include "ffsim/fcidump.hpp"
+#include "ffsim/mp2.hpp"
+#include "ffsim/sample_slater.hpp"
+#include "ffsim/states.hpp"
 #include "ffsim/ucj.hpp"
 #include "ffsim/ucjop_spinbalanced.hpp"
+#include "input_helper.hpp"
 #include "load_parameters.hpp"
 #include "qiskit/addon/sqd/configuration_recovery.hpp"
 #include "qiskit/addon/sqd/subsampling.hpp"
+#include "sampler_cache_helper.hpp"
 #include "sbd_helper.hpp"
 #include "sqd_helper.hpp"
 
@@ -44,109 +50,68 @@ using namespace Qiskit::compiler;
 using Sampler = BackendSamplerV2;
 
 // Test stub: generate num_samples random bitstrings of length num_bits
-// with Bernoulli(p=0.5) and aggregate into counts (bitstring -> occurrences).
+// with Bernoulli(p=0.5) and pass each shot to the given sink.
 // Use this when a real backend/simulator is unavailable (debugging).
-std::unordered_map<std::string, uint64_t> generate_counts_uniform(
+template <typename Sink>
+void generate_shots_uniform(
     int num_samples, // NOLINT(bugprone-easily-swappable-parameters)
     int num_bits,    // NOLINT(bugprone-easily-swappable-parameters)
-    std::optional<unsigned int> seed = std::nullopt
+    std::optional<unsigned int> seed, Sink &&sink
 )
 {
     std::mt19937 rng(seed.value_or(std::random_device{}()));
     std::bernoulli_distribution dist(0.5);
 
-    std::unordered_map<std::string, uint64_t> counts;
-
+    std::string bitstring;
+    bitstring.reserve(num_bits);
     for (int i = 0; i < num_samples; ++i) {
-        std::string bitstring;
-        bitstring.reserve(num_bits);
+        bitstring.clear();
         for (int j = 0; j < num_bits; ++j) {
             bitstring += dist(rng) ? '1' : '0';
         }
-        counts[bitstring]++;
+        sink(bitstring);
     }
-    return counts;
 }
 
-// Load initial alpha/beta occupancies from a JSON file.
-// Format: { "init_occupancies": [ alpha..., beta... ] }  (even length)
-// After splitting, reverse each to match the internal right-to-left convention.
-std::array<std::vector<double>, 2> load_initial_occupancies(const std::string &filename)
+// Test stub: aggregate uniform random shots into counts (bitstring ->
+// occurrences).
+std::unordered_map<std::string, uint64_t> generate_counts_uniform(
+    int num_samples, // NOLINT(bugprone-easily-swappable-parameters)
+    int num_bits,    // NOLINT(bugprone-easily-swappable-parameters)
+    std::optional<unsigned int> seed = std::nullopt
+)
 {
-    std::ifstream i(filename);
-    nlohmann::json input;
-    i >> input;
-
-    // Validate input JSON: throw on missing key to fail fast on user error.
-    if (!input.contains("init_occupancies"))
-        throw std::invalid_argument(
-            "no init_params in initial parameter json: file=" + filename
-        );
-    std::vector<double> init_occupancy = input["init_occupancies"];
-
-    if ((init_occupancy.size() & 1) != 0) {
-        throw std::runtime_error(
-            "Initial occupancies list must have even number of elements"
-        );
-    }
-    const auto half_size = init_occupancy.size() / 2;
+    std::unordered_map<std::string, uint64_t> counts;
+    generate_shots_uniform(num_samples, num_bits, seed, [&](const std::string &b) {
+        counts[b]++;
+    });
+    return counts;
+}
 
+// Split the initial occupancies of the input bundle, alpha then beta with
+// orbital 0 first, and reverse each to match the internal right-to-left
+// convention.
+std::array<std::vector<double>, 2> split_initial_occupancies(const InputBundle &input)
+{
+    const auto &init_occupancy = input.occupancies;
+    const auto half_size = static_cast<std::ptrdiff_t>(init_occupancy.size() / 2);
     std::vector<double> alpha_occupancy(
-        init_occupancy.begin(),
-        init_occupancy.begin() + static_cast<std::ptrdiff_t>(half_size)
+        init_occupancy.begin(), init_occupancy.begin() + half_size
     );
     std::vector<double> beta_occupancy(
-        init_occupancy.begin() + static_cast<std::ptrdiff_t>(half_size),
-        init_occupancy.end()
-    );
-
-    std::reverse(alpha_occupancy.begin(), alpha_occupancy.end());
-    std::reverse(beta_occupancy.begin(), beta_occupancy.end());
-
-    return {alpha_occupancy, beta_occupancy};
-}
-
-// Utility: normalize counts (occurrences) into probabilities in [0,1].
-// Empty input returns an empty map (no exception).
-std::unordered_map<std::string, double>
-normalize_counts_dict(const std::unordered_map<std::string, uint64_t> &counts)
-{
-    // Check if the input map is empty
-    if (counts.empty()) {
-        return {}; // Return an empty map
-    }
-
-    // Calculate the total counts
-    uint64_t total_counts = std::accumulate(
-        counts.begin(), counts.end(), 0, [](uint64_t sum, const auto &pair) {
-            return sum + pair.second;
-        }
+        init_occupancy.begin() + half_size, init_occupancy.end()
     );
-
-    // Create a new map with normalized values
-    std::unordered_map<std::string, double> probabilities;
-    for (const auto &[key, value] : counts) {
-        probabilities[key] =
-            static_cast<double>(value) / static_cast<double>(total_counts);
-    }
-
-    return probabilities;
+    return to_recovery_order({alpha_occupancy, beta_occupancy});
 }
 
-// Transform counts (bitstring -> count) into parallel arrays (bitstrings,
-// probabilities).
+// Transform probabilities (bitstring -> probability) into parallel arrays
+// (bitstrings, probabilities).
 std::pair<std::vector<boost::dynamic_bitset<>>, std::vector<double>>
-counts_to_arrays(const std::unordered_map<std::string, uint64_t> &counts)
+probabilities_to_arrays(const std::unordered_map<std::string, double> &prob_dict)
 {
     std::vector<boost::dynamic_bitset<>> bs_mat;
     std::vector<double> freq_arr;
 
-    if (counts.empty())
-        return {bs_mat, freq_arr};
-
-    // Normalize the counts to probabilities
-    auto prob_dict = normalize_counts_dict(counts);
-
     // Convert bitstrings to a 2D boolean matrix
     for (const auto &[bitstring, _] : prob_dict) {
         bs_mat.emplace_back(bitstring);
@@ -190,6 +155,15 @@ int main(int argc, char *argv[])
         // Holds run_id, backend, shot count, and other metadata for sampling and
         // recovery.
         SQD sqd_data = generate_sqd_data(argc, argv);
+        diag_data.pt2.cholesky_tol = sqd_data.cholesky_tol;
+#if USE_RANDOM_SHOTS != 0
+        // Mock shots have no readout errors and there is no device to calibrate.
+        if (sqd_data.mitigation.enabled) {
+            throw std::invalid_argument(
+                "--readout_mitigation needs backend shots, not a USE_RANDOM_SHOTS build"
+            );
+        }
+#endif
         sqd_data.comm = MPI_COMM_WORLD;
         MPI_Comm_rank(sqd_data.comm, &sqd_data.mpi_rank);
         MPI_Comm_size(sqd_data.comm, &sqd_data.mpi_size);
@@ -207,50 +181,116 @@ int main(int argc, char *argv[])
         //  - rc_rng : used for configuration recovery randomness (derived from rng).
         std::mt19937 rng(1234);
         std::mt19937 rc_rng(rng());
-        // Batch sizing for SBD input (alpha-determinant groups).
-        uint64_t samples_per_batch = sqd_data.samples_per_batch;
 
         // Read initial parameters (norb, nelec, params for lucj) from JSON.
         const std::string input_file_path = "../data/parameters_fe4s4.json";
+        const std::string occupancy_file_path =
+            "../data/initial_occupancies_fe4s4.json";
         double tol = 1e-8;
-        uint64_t norb;
         size_t n_reps = 1;
-        std::pair<uint64_t, uint64_t> nelec;
-        std::vector<std::pair<uint64_t, uint64_t>> interaction_aa;
-        std::vector<std::pair<uint64_t, uint64_t>> interaction_ab;
-        std::vector<double> init_params;
+        // Every input file is read by rank 0 only and reaches the other ranks as one
+        // packed broadcast.
+        InputBundle input;
+        // With --lucj_params mp2 the amplitudes are computed from the FCIDUMP
+        // integrals instead of being read from the parameter file.
+        std::optional<ffsim::MP2Result> mp2_amplitudes;
 
         // Centralize I/O on rank 0. Abort the whole job on input failure.
         if (sqd_data.mpi_rank == 0) {
             try {
-                load_initial_parameters(
-                    input_file_path, norb, nelec, interaction_aa, interaction_ab,
-                    init_params
-                );
+                if (!sqd_data.input_bundle.empty()) {
+                    input = read_input_bundle(sqd_data.input_bundle);
+                } else {
+                    if (sqd_data.lucj_params != "mp2") {
+                        load_parameter_input(input_file_path, input);
+                    }
+                    if (sqd_data.initial_occupancies == "file") {
+                        load_occupancy_input(occupancy_file_path, input);
+                    }
+                }
+                if (sqd_data.lucj_params == "mp2") {
+                    auto fcidump = load_integrals(sqd_data, diag_data.fcidumpfile);
+                    std::vector<std::pair<uint64_t, uint64_t>> pairs_aa, pairs_ab;
+                    default_interaction_pairs(fcidump.norb, pairs_aa, pairs_ab);
+                    input.norb = fcidump.norb;
+                    auto [n_alpha, n_beta] = fcidump.nelec_pair();
+                    input.nelec = {n_alpha, n_beta};
+                    input.alpha_alpha_indices.clear();
+                    for (const auto &[p, q] : pairs_aa) {
+                        input.alpha_alpha_indices.insert(
+                            input.alpha_alpha_indices.end(), {p, q}
+                        );
+                    }
+                    input.alpha_beta_indices.clear();
+                    for (const auto &[p, q] : pairs_ab) {
+                        input.alpha_beta_indices.insert(
+                            input.alpha_beta_indices.end(), {p, q}
+                        );
+                    }
+                    input.params.clear();
+                    mp2_amplitudes = ffsim::mp2(fcidump);
+                }
+                if (sqd_data.initial_occupancies == "file" &&
+                    input.occupancies.empty()) {
+                    throw std::invalid_argument(
+                        sqd_data.input_bundle.empty()
+                            ? "no init_occupancies in initial occupancy json: file=" +
+                                  occupancy_file_path
+                            : "no init_occupancies in input bundle: file=" +
+                                  sqd_data.input_bundle
+                    );
+                }
+                if (sqd_data.initial_occupancies == "mp2" && !mp2_amplitudes) {
+                    mp2_amplitudes =
+                        ffsim::mp2(load_integrals(sqd_data, diag_data.fcidumpfile));
+                }
+                if (!sqd_data.write_input_bundle.empty()) {
+                    write_input_bundle(input, sqd_data.write_input_bundle);
+                }
             } catch (const std::exception &e) {
                 std::cerr << "Error loading initial parameters: " << e.what()
                           << std::endl;
                 MPI_Abort(sqd_data.comm, 1);
                 return 1;
             }
-            log(sqd_data, {"initial parameters are loaded. param_length=",
-                           std::to_string(init_params.size())});
+            if (mp2_amplitudes.has_value()) {
+                log(sqd_data, {"MP2 amplitudes are computed. correlation energy=",
+                               std::to_string(mp2_amplitudes->energy)});
+            }
+            if (sqd_data.lucj_params != "mp2") {
+                log(sqd_data, {"initial parameters are loaded. param_length=",
+                               std::to_string(input.params.size())});
+            }
         }
+        bcast_input(input, 0, sqd_data.comm);
+        if (input.nelec.size() != 2) {
+            std::cerr << "Error loading initial parameters: no electron counts"
+                      << std::endl;
+            MPI_Abort(sqd_data.comm, 1);
+            return 1;
+        }
+        const uint64_t norb = input.norb;
+        const std::pair<uint64_t, uint64_t> nelec = {input.nelec[0], input.nelec[1]};
+        const auto interaction_aa = to_pairs(input.alpha_alpha_indices);
+        const auto interaction_ab = to_pairs(input.alpha_beta_indices);
+        const std::vector<double> &init_params = input.params;
 
         // Measurement results: (bitstring -> counts). Produced on rank 0, then
         // array-ified later.
         std::unordered_map<std::string, uint64_t> counts;
+        // Shots that arrive as packed words, such as those of the local Slater
+        // sampler, are counted here without a detour through strings; counts is
+        // merged in before recovery.
+        PackedCounts packed_counts(2 * norb);
+        // Readout-mitigated probabilities; empty unless --readout_mitigation is set.
+        std::unordered_map<std::string, double> mitigated_probs;
 
         auto num_elec_a = nelec.first;
         auto num_elec_b = nelec.second;
+        // Prior occupancies (orbital 0 first) when computed instead of loaded.
+        std::array<std::vector<double>, 2> computed_occupancies;
         if (sqd_data.mpi_rank == 0) {
-// ===== Sampling mode switch =====
-// a) Mock: generate_counts_uniform (debugging)
-// b) Real: build LUCJ circuit -> transpile -> run on backend with Sampler -> get counts
-#if USE_RANDOM_SHOTS != 0
-            counts = generate_counts_uniform(sqd_data.num_shots, 2 * norb, 1234);
-#else
-            //////////////// LUCJ Circuit Generation ////////////////
+            //////////////// LUCJ Operator ////////////////
             size_t params_size = init_params.size();
 
             Eigen::VectorXcd params(params_size);
@@ -270,14 +310,100 @@ int main(int argc, char *argv[])
                     )
                 };
 
-            // Construct the spin-balanced UCJ operator from parameter vector.
+            // Construct the spin-balanced UCJ operator from the MP2 amplitudes or
+            // from the parameter vector.
+            UCJOpSpinBalanced ucj_op =
+                sqd_data.lucj_params == "mp2"
+                    ? UCJOpSpinBalanced::from_t_amplitudes(
+                          mp2_amplitudes->t2, mp2_amplitudes->t1, n_reps,
+                          interaction_pairs, tol
+                      )
+                    : UCJOpSpinBalanced::from_parameters(
+                          params, norb, n_reps, interaction_pairs, true
+                      );
+
+            if (sqd_data.initial_occupancies == "lucj") {
+                // Exact occupancies of the simulated LUCJ state. The state vector
+                // has C(norb, n_alpha) * C(norb, n_beta) entries, so this is only
+                // feasible for small active spaces.
+                auto psi = ffsim::apply_ucj_op_spin_balanced(
+                    ffsim::hartree_fock_state(norb, nelec), ucj_op, nelec
+                );
+                computed_occupancies = ffsim::orbital_occupancies(psi, norb, nelec);
+            } else if (sqd_data.initial_occupancies == "mp2") {
+                // Closed shell: each spin holds half of the MP2 density diagonal.
+                const Eigen::VectorXd diagonal = mp2_amplitudes->rdm1.diagonal();
+                std::vector<double> occupancies(diagonal.size());
+                for (Eigen::Index p = 0; p < diagonal.size(); ++p) {
+                    occupancies[p] = 0.5 * diagonal(p);
+                }
+                computed_occupancies = {occupancies, occupancies};
+            }
 
-            UCJOpSpinBalanced ucj_op = UCJOpSpinBalanced::from_parameters(
-                params, norb, n_reps, interaction_pairs, true
-            );
+            // With a counts capacity only the heaviest bitstrings are kept, in
+            // bounded memory, and the remaining shots are reported as the tail.
+            std::optional<HeavyHitterCounts> heavy_hitters;
+            if (sqd_data.streaming.enabled()) {
+                heavy_hitters.emplace(sqd_data.streaming.capacity);
+            }
+            auto collect_heavy_hitters = [&]() {
+                counts = heavy_hitters->counts();
+                log(sqd_data,
+                    {"heavy-hitter counts: kept=", std::to_string(counts.size()),
+                     ", tail shots=", std::to_string(heavy_hitters->tail_count()),
+                     ", max error=", std::to_string(heavy_hitters->max_error())});
+            };
+
+// ===== Sampling mode switch =====
+// a) Mock: generate_counts_uniform or exact Slater-determinant samples (debugging)
+// b) Real: build LUCJ circuit -> transpile -> run on backend with Sampler -> get counts
+#if USE_RANDOM_SHOTS != 0
+            if (sqd_data.mock_sampler == "slater") {
+                // Exact samples of the Hartree-Fock determinant in the orbitals of
+                // the first LUCJ layer, drawn without a state vector.
+                const auto n = static_cast<Eigen::Index>(norb);
+                MatrixXcd rotation(n, n);
+                for (Eigen::Index p = 0; p < n; ++p) {
+                    for (Eigen::Index q = 0; q < n; ++q) {
+                        rotation(p, q) = ucj_op.orbital_rotations(0, p, q);
+                    }
+                }
+                std::vector<uint64_t> occ_a(num_elec_a), occ_b(num_elec_b);
+                std::iota(occ_a.begin(), occ_a.end(), 0);
+                std::iota(occ_b.begin(), occ_b.end(), 0);
+                OrbitalRotation rotated{
+                    OrbitalRotationType::Spinless, rotation,
+                    {std::nullopt, std::nullopt}
+                };
+                if (heavy_hitters) {
+                    for (const auto &shot : ffsim::sample_slater_determinant(
+                             norb, {occ_a, occ_b}, rotated, sqd_data.num_shots, 1234
+                         )) {
+                        heavy_hitters->add(shot);
+                    }
+                    collect_heavy_hitters();
+                } else {
+                    packed_counts.add_shots(ffsim::sample_slater_determinant_packed(
+                        norb, {occ_a, occ_b}, rotated, sqd_data.num_shots, 1234
+                    ));
+                }
+            } else if (heavy_hitters) {
+                generate_shots_uniform(
+                    sqd_data.num_shots, 2 * norb, 1234,
+                    [&](const std::string &b) { heavy_hitters->add(b); }
+                );
+                collect_heavy_hitters();
+            } else {
+                counts = generate_counts_uniform(sqd_data.num_shots, 2 * norb, 1234);
+            }
+#else
+            //////////////// LUCJ Circuit Generation ////////////////
             std::vector<uint32_t> qubits(2 * norb);
             std::iota(qubits.begin(), qubits.end(), 0);
             auto instructions = hf_and_ucj_op_spin_balanced_jw(qubits, nelec, ucj_op);
+            log(sqd_data,
+                {"circuit instructions are generated. scratch arena peak=",
+                 std::to_string(ffsim::Arena::global_peak_bytes()), " bytes"});
 
             // Quantum circuit with Qiskit C++
             auto qr = QuantumRegister(2 * norb);   // quantum registers
@@ -332,93 +458,184 @@ int main(int argc, char *argv[])
 
             uint64_t num_shots = sqd_data.num_shots;
 
-            // Configure the Sampler execution (num_shots from SQD configuration).
-            auto sampler = Sampler(backend, num_shots);
-
-            auto job = sampler.run({SamplerPub(transpiled)});
-            if (job == nullptr)
-                return -1;
-            auto result = job->result();
-            auto pub_result = result[0];
+            // Jobs whose transpiled circuits, backend and shots match an earlier
+            // run are read back from the local cache instead of being resubmitted,
+            // unless --fresh_samples is given.
+            SamplerCache cache(sqd_data.sampler_cache, !sqd_data.fresh_samples);
+            // Runs one sampler job with a pub per circuit and returns the packed
+            // counts of each pub, or reads all of them from the cache if cacheable.
+            auto run_cached = [&](const std::vector<QuantumCircuit> &circuits,
+                                  uint64_t shots, bool cacheable) {
+                std::vector<SamplerCacheKey> keys;
+                std::vector<PackedCounts> pub_counts;
+                for (const auto &circuit : circuits) {
+                    keys.push_back({circuit.to_qasm3(), backend_name, shots});
+                    pub_counts.emplace_back(2 * norb);
+                }
+                bool hit = cacheable;
+                for (size_t i = 0; i < keys.size() && hit; ++i) {
+                    hit = cache.load(keys[i], pub_counts[i]);
+                }
+                if (hit) {
+                    // Printed even without --verbose: these shots are not new.
+                    std::cout << get_time() << ": sampler cache hit, "
+                              << keys.size() << " pub(s) read from "
+                              << cache.path(keys[0]) << " instead of running on "
+                              << backend_name << " (--fresh_samples resubmits)"
+                              << std::endl;
+                    return std::optional<std::vector<PackedCounts>>(pub_counts);
+                }
+                std::vector<SamplerPub> pubs;
+                for (const auto &circuit : circuits) {
+                    pubs.push_back(SamplerPub(circuit));
+                }
+                auto job = Sampler(backend, shots).run(pubs);
+                if (job == nullptr) {
+                    return std::optional<std::vector<PackedCounts>>();
+                }
+                auto result = job->result();
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    // Counted from the packed shot words when the qiskit-cpp bit
+                    // array provides packed_words(); the pinned version does not,
+                    // so backend results still come through get_counts() strings.
+                    pub_counts[i] = PackedCounts(2 * norb);
+                    add_bit_array(pub_counts[i], result[i].data());
+                    if (cacheable) {
+                        cache.store(keys[i], pub_counts[i]);
+                    }
+                }
+                return std::optional<std::vector<PackedCounts>>(pub_counts);
+            };
+
+            if (heavy_hitters) {
+                // In bounded-memory mode the shots are split into jobs of
+                // chunk_shots, so that only one job's histogram exists next to the
+                // heavy-hitter summary. These jobs bypass the cache, which would
+                // have to hold the full histogram.
+                uint64_t chunk_shots =
+                    std::max<uint64_t>(1, sqd_data.streaming.chunk_shots);
+                for (uint64_t done = 0; done < num_shots; done += chunk_shots) {
+                    auto sampler =
+                        Sampler(backend, std::min(chunk_shots, num_shots - done));
+                    auto job = sampler.run({SamplerPub(transpiled)});
+                    if (job == nullptr)
+                        return -1;
+                    auto result = job->result();
+                    heavy_hitters->add(result[0].data().get_counts());
+                }
+                collect_heavy_hitters();
+            } else {
+                // Extract classical counts from the execution result.
+                // These form the classical distribution for downstream
+                // recovery/selection.
+                auto sampled = run_cached({transpiled}, num_shots, true);
+                if (!sampled)
+                    return -1;
+                if (sqd_data.mitigation.enabled) {
+                    counts = (*sampled)[0].to_counts();
+                } else {
+                    packed_counts = std::move((*sampled)[0]);
+                }
+            }
 
-            // Extract classical counts from the execution result.
-            // These form the classical distribution for downstream recovery/selection.
-            counts = pub_result.data().get_counts();
+            if (sqd_data.mitigation.enabled) {
+                // Calibration circuits preparing every qubit in |0> and in |1>.
+                // They are always resubmitted: readout errors drift between
+                // device calibrations, while the circuits and so the cache keys
+                // stay the same.
+                auto zeros = QuantumCircuit(qr, cr);
+                auto ones = QuantumCircuit(qr, cr);
+                for (size_t i = 0; i < 2 * norb; ++i) {
+                    ones.x(i);
+                }
+                for (size_t i = 0; i < 2 * norb; ++i) {
+                    zeros.measure(i, i);
+                    ones.measure(i, i);
+                }
+                auto cal_sampled = run_cached(
+                    {transpile(zeros, backend), transpile(ones, backend)},
+                    sqd_data.mitigation.calibration_shots, false
+                );
+                if (!cal_sampled)
+                    return -1;
+                auto calibration = calibrate_readout(
+                    (*cal_sampled)[0].to_counts(), (*cal_sampled)[1].to_counts(),
+                    2 * norb
+                );
+                auto mitigated =
+                    mitigate_readout(counts, calibration, sqd_data.mitigation);
+                log(sqd_data, {"readout mitigation: iterations=",
+                               std::to_string(mitigated.iterations),
+                               ", error=", std::to_string(mitigated.error)});
+                mitigated_probs = std::move(mitigated.probabilities);
+            }
 #endif // USE_RANDOM_SHOTS
         }
 
         ////// Configuration Recovery, Subsampling, Diagonalization //////
 
-        // Expand counts (map) into (bitstrings[], probs[]).
-        auto [bitstring_matrix_full, probs_arr_full] = counts_to_arrays(counts);
+        // Expand counts (packed table or map) into (bitstrings[], probs[]).
+        packed_counts.add(counts);
+        auto [bitstring_matrix_full, probs_arr_full] =
+            mitigated_probs.empty() ? packed_counts.to_arrays()
+                                    : probabilities_to_arrays(mitigated_probs);
 
-        std::vector<boost::dynamic_bitset<>> bs_mat_tmp;
-        std::vector<double> probs_arr_tmp;
         std::array<std::vector<double>, 2> latest_occupancies, initial_occupancies;
         int n_recovery = static_cast<int>(sqd_data.n_recovery);
 
-        try {
-            // Load prior alpha/beta occupancies used as the initial distribution for
-            // recovery.
-            initial_occupancies =
-                load_initial_occupancies("../data/initial_occupancies_fe4s4.json");
-        } catch (const std::invalid_argument &e) {
-            std::cerr << "Error loading initial occupancies: " << e.what() << std::endl;
-            return 1;
+        if (sqd_data.initial_occupancies == "file") {
+            // Prior alpha/beta occupancies used as the initial distribution for
+            // recovery, received with the other inputs.
+            initial_occupancies = split_initial_occupancies(input);
+        } else {
+            // Computed on rank 0 above; every rank needs them for the size checks.
+            initial_occupancies = to_recovery_order(computed_occupancies);
+            bcast_occupancies(initial_occupancies, sqd_data.comm);
+            log(sqd_data, {"initial occupancies are computed from ",
+                           sqd_data.initial_occupancies});
         }
+        // Accelerates the self-consistency of the occupancies over the recovery
+        // iterations when --occupancy_mixing is set.
+        AndersonMixer occupancy_mixer(sqd_data.mixing.history, sqd_data.mixing.damping);
         // ===== Configuration recovery loop (n_recovery iterations) =====
         // Each iter: recover_configurations → subsample → SBD
         // (diagonalize) → update occupancies.
         for (uint64_t i_recovery = 0; i_recovery < n_recovery; ++i_recovery) {
             log(sqd_data, {"start recovery: iteration=", std::to_string(i_recovery)});
 
-            // Iteration 0: feed full bitstring/probability sets and seed recovery from
-            // initial occupancies.
+            // Iteration 0: seed recovery from the initial occupancies.
             if (i_recovery == 0) {
-                bs_mat_tmp = bitstring_matrix_full;
-                probs_arr_tmp = probs_arr_full;
                 latest_occupancies = initial_occupancies;
             }
             if (sqd_data.mpi_rank == 0) {
-                // Recover physically consistent configurations from observed
-                // probabilities
-                // + prior occupancies.
-                auto recovered = Qiskit::addon::sqd::recover_configurations(
-                    bitstring_matrix_full, probs_arr_full, latest_occupancies,
-                    {num_elec_a, num_elec_b}, rc_rng
-                );
-                bs_mat_tmp = std::move(recovered.first);
-                probs_arr_tmp = std::move(recovered.second);
-
-                log(sqd_data, {"Number of recovered bitstrings: ",
-                               std::to_string(bs_mat_tmp.size())});
-
-                // Subsample to a single batch of fixed size for SBD, to cap IO/compute
-                // per iteration.
-                std::vector<boost::dynamic_bitset<>> batch;
-                Qiskit::addon::sqd::subsample(
-                    batch, bs_mat_tmp, probs_arr_tmp, samples_per_batch, rng
-                );
-                // Write alpha-determinants file for SBD input (includes run id /
-                // iteration for traceability).
-                diag_data.adetfile = write_alphadets_file(
-                    sqd_data, norb, num_elec_a, batch, sqd_data.samples_per_batch * 2,
-                    i_recovery
+                // Alpha-determinants file for SBD input (includes run id / iteration
+                // for traceability).
+                diag_data.adetfile = recover_alphadets(
+                    sqd_data, bitstring_matrix_full, probs_arr_full,
+                    latest_occupancies, norb, nelec, i_recovery, rng, rc_rng
                 );
             }
             // Run SBD to get energy and batch occupancies (interleaved alpha/beta...).
             // Energy goes to logs; occupancies seed the next iteration.
-            auto [energy_sci, occs_batch] = sbd_main(sqd_data.comm, diag_data);
+            auto [energy_sci, occs_batch, pt2, excited] =
+                sbd_main(sqd_data.comm, diag_data);
             log(sqd_data, {"energy: ", std::to_string(energy_sci)});
-
-            // Convert interleaved [alpha0, beta0, alpha1, beta1, ...] to { alpha[],
-            // beta[]
-            // }. NOTE: assert ensures occs_batch size matches 2 * alpha.size().
-            assert(2 * latest_occupancies[0].size() == occs_batch.size());
-            for (std::size_t j = 0; j < latest_occupancies[0].size(); ++j) {
-                latest_occupancies[0][j] = occs_batch[2 * j];     // alpha orbital
-                latest_occupancies[1][j] = occs_batch[2 * j + 1]; // beta orbital
+            for (size_t root = 0; root < excited.energies.size(); ++root) {
+                log(sqd_data,
+                    {"energy[", std::to_string(root + 1),
+                     "]: ", std::to_string(excited.energies[root])});
+            }
+            if (diag_data.pt2.enabled) {
+                log(sqd_data,
+                    {"pt2 correction: ", std::to_string(pt2.energy), " +/- ",
+                     std::to_string(pt2.error)});
             }
+
+            // Interleaved [alpha0, beta0, alpha1, beta1, ...] back to { alpha[],
+            // beta[] }, the occupancies of the next iteration.
+            update_occupancies(
+                sqd_data, latest_occupancies, occs_batch, occupancy_mixer
+            );
         }
 
         // Synchronize and tear down MPI. No MPI calls are allowed beyond this point.
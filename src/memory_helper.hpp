@@ -0,0 +1,135 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef MEMORY_HELPER_HPP_
+#define MEMORY_HELPER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace memory
+{
+
+constexpr size_t huge_page_bytes = size_t(2) << 20;
+
+// Whole pages of align bytes inside [data, data + bytes), empty if none.
+inline std::pair<uintptr_t, uintptr_t>
+aligned_range(void *data, size_t bytes, size_t align)
+{
+    auto begin = reinterpret_cast<uintptr_t>(data);
+    uintptr_t first = (begin + align - 1) & ~(align - 1);
+    uintptr_t last = (begin + bytes) & ~(align - 1);
+    return {first, std::max(first, last)};
+}
+
+// Asks the kernel to back the 2 MiB aligned part of [data, data + bytes) with
+// transparent huge pages. Must come before the pages are first touched. Returns
+// false where the advice is unavailable.
+inline bool advise_huge_pages(void *data, size_t bytes)
+{
+#ifdef MADV_HUGEPAGE
+    auto [first, last] = aligned_range(data, bytes, huge_page_bytes);
+    if (last == first) {
+        return false;
+    }
+    return madvise(reinterpret_cast<void *>(first), last - first, MADV_HUGEPAGE) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    return false;
+#endif
+}
+
+// Hands the whole pages of [data, data + bytes) back to the kernel. The memory
+// of the allocator is private and anonymous, so those pages read back as zeros
+// and are mapped again on the NUMA node of the thread that touches them next.
+// Returns false where this is unavailable, leaving the pages where they are.
+inline bool release_pages(void *data, size_t bytes)
+{
+#ifdef MADV_DONTNEED
+    auto [first, last] =
+        aligned_range(data, bytes, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    if (last == first) {
+        return false;
+    }
+    return madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    return false;
+#endif
+}
+
+} // namespace memory
+
+// Placement of the large per-rank arrays of the diagonalization: "default" leaves
+// it to the allocator, "first_touch" zeroes new storage with a static OpenMP
+// split so each page lands on the NUMA node of the thread that works on it, and
+// "huge_pages" additionally requests transparent huge pages.
+struct PagePlacement {
+    bool first_touch = false;
+    bool huge_pages = false;
+
+    static PagePlacement parse(const std::string &mode)
+    {
+        if (mode == "default") {
+            return {false, false};
+        }
+        if (mode == "first_touch") {
+            return {true, false};
+        }
+        if (mode == "huge_pages") {
+            return {true, true};
+        }
+        throw std::invalid_argument("unknown page placement: " + mode);
+    }
+};
+
+// Returns n zeros placed by the threads that will use them.
+//
+// The arrays are handed to SBD as std::vector<double>, so the allocator cannot
+// be swapped. The vector is created at its final size, which zeroes it on the
+// calling thread; its pages are then released and zeroed again in parallel with
+// the split of schedule(static), so that each one is mapped anew where it is
+// first touched. SBD resizing within that size keeps the storage.
+std::vector<double> first_touch_vector(size_t n, const PagePlacement &place)
+{
+    std::vector<double> vec(n, 0.0);
+    if (!place.first_touch || n == 0) {
+        return vec;
+    }
+    double *data = vec.data();
+    memory::release_pages(data, n * sizeof(double));
+    if (place.huge_pages) {
+        memory::advise_huge_pages(data, n * sizeof(double));
+    }
+    const auto size = static_cast<int64_t>(n);
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < size; ++i) {
+        data[i] = 0.0;
+    }
+    return vec;
+}
+
+#endif // MEMORY_HELPER_HPP_
@@ -0,0 +1,362 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef MITIGATION_HELPER_HPP_
+#define MITIGATION_HELPER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/Sparse>
+
+// Settings of the readout-error mitigation stage.
+struct ReadoutMitigation {
+    bool enabled = false;
+    // Observed bitstrings farther apart than this are not coupled by the reduced
+    // assignment matrix.
+    int distance = 3;
+    uint64_t calibration_shots = 10000; // shots per calibration circuit
+    double tol = 1.0e-8;                // relative residual of the linear solve
+    int max_iterations = 100;
+};
+
+// Quasi-probabilities recovered from the measured counts, projected onto the
+// nearest probability distribution, and the convergence of the linear solve.
+struct MitigationResult {
+    std::unordered_map<std::string, double> probabilities;
+    int iterations = 0;
+    double error = 0.0;
+};
+
+// Readout assignment matrix of one qubit, A[measured][prepared].
+using AssignmentMatrix = std::array<std::array<double, 2>, 2>;
+
+namespace mitigation
+{
+
+// Throws unless bitstring has one bit per calibrated qubit.
+inline void check_width(const std::string &bitstring, size_t num_qubits)
+{
+    if (bitstring.size() != num_qubits) {
+        throw std::invalid_argument(
+            "bitstring of " + std::to_string(bitstring.size()) +
+            " bits does not match the readout calibration of " +
+            std::to_string(num_qubits) + " qubits"
+        );
+    }
+}
+
+// Bitstring in Qiskit order (qubit q is character n - 1 - q) packed into words,
+// qubit q at bit q % 64 of word q / 64.
+inline std::vector<uint64_t> pack_bitstring(const std::string &bitstring)
+{
+    const size_t n = bitstring.size();
+    std::vector<uint64_t> words((n + 63) / 64, 0);
+    for (size_t q = 0; q < n; ++q) {
+        if (bitstring[n - 1 - q] == '1') {
+            words[q / 64] |= 1ULL << (q % 64);
+        }
+    }
+    return words;
+}
+
+// Replaces quasi-probabilities summing to one by the closest probability
+// distribution in the 2-norm (Smolin, Gambetta, Smith, PRL 108, 070502).
+inline void nearest_probability_distribution(std::vector<double> &quasi)
+{
+    const size_t n = quasi.size();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return quasi[a] < quasi[b];
+    });
+    double accumulated = 0.0;
+    size_t k = 0;
+    for (; k < n; ++k) {
+        double shift = accumulated / static_cast<double>(n - k);
+        if (quasi[order[k]] + shift >= 0.0) {
+            break;
+        }
+        accumulated += quasi[order[k]];
+        quasi[order[k]] = 0.0;
+    }
+    if (k < n) {
+        double shift = accumulated / static_cast<double>(n - k);
+        for (size_t i = k; i < n; ++i) {
+            quasi[order[i]] += shift;
+        }
+    }
+}
+
+// Hash of packed bitstrings, the splitmix64 finalizer folded over the words.
+struct PackedHash {
+    size_t operator()(const std::vector<uint64_t> &words) const
+    {
+        uint64_t h = 0x9e3779b97f4a7c15ULL;
+        for (uint64_t word : words) {
+            uint64_t x = h ^ word;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            h = x ^ (x >> 31);
+        }
+        return static_cast<size_t>(h);
+    }
+};
+
+// Number of bitstrings of num_qubits qubits within distance of a given one,
+// saturating at limit.
+inline uint64_t hamming_ball_size(size_t num_qubits, int distance, uint64_t limit)
+{
+    uint64_t size = 0;
+    uint64_t binomial = 1;
+    for (int k = 0; k <= distance && static_cast<size_t>(k) <= num_qubits; ++k) {
+        size += binomial;
+        if (size >= limit) {
+            return limit;
+        }
+        // C(n, k + 1) = C(n, k) (n - k) / (k + 1), exact in this order.
+        binomial = binomial * (num_qubits - k) / static_cast<uint64_t>(k + 1);
+    }
+    return size;
+}
+
+// Calls visit(neighbor) for every bitstring obtained from center by flipping at
+// most distance qubits, center included, each once.
+template <typename Visit>
+void for_each_in_hamming_ball(
+    std::vector<uint64_t> &center, size_t num_qubits, int distance,
+    size_t first_qubit, const Visit &visit
+)
+{
+    visit(center);
+    if (distance == 0) {
+        return;
+    }
+    for (size_t q = first_qubit; q < num_qubits; ++q) {
+        center[q / 64] ^= 1ULL << (q % 64);
+        for_each_in_hamming_ball(center, num_qubits, distance - 1, q + 1, visit);
+        center[q / 64] ^= 1ULL << (q % 64);
+    }
+}
+
+// Smallest diagonal element accepted in an assignment matrix. Below it the
+// qubit reads its prepared state almost never, and dividing by the element in
+// the reduced assignment matrix would amplify noise without bound.
+constexpr double min_assignment_diagonal = 1.0e-3;
+
+} // namespace mitigation
+
+// Builds per-qubit assignment matrices from the counts of two calibration
+// circuits that prepare every qubit in |0> and every qubit in |1>. Throws if a
+// qubit reads its prepared state with probability below
+// mitigation::min_assignment_diagonal, which no mitigation can correct.
+std::vector<AssignmentMatrix> calibrate_readout(
+    const std::unordered_map<std::string, uint64_t> &zeros_counts,
+    const std::unordered_map<std::string, uint64_t> &ones_counts, size_t num_qubits
+)
+{
+    std::vector<AssignmentMatrix> calibration(num_qubits);
+    std::vector<double> flips_0(num_qubits, 0.0), flips_1(num_qubits, 0.0);
+    double total_0 = 0.0, total_1 = 0.0;
+    for (const auto &[bitstring, count] : zeros_counts) {
+        mitigation::check_width(bitstring, num_qubits);
+        for (size_t q = 0; q < num_qubits; ++q) {
+            if (bitstring[num_qubits - 1 - q] == '1') {
+                flips_0[q] += static_cast<double>(count);
+            }
+        }
+        total_0 += static_cast<double>(count);
+    }
+    for (const auto &[bitstring, count] : ones_counts) {
+        mitigation::check_width(bitstring, num_qubits);
+        for (size_t q = 0; q < num_qubits; ++q) {
+            if (bitstring[num_qubits - 1 - q] == '0') {
+                flips_1[q] += static_cast<double>(count);
+            }
+        }
+        total_1 += static_cast<double>(count);
+    }
+    for (size_t q = 0; q < num_qubits; ++q) {
+        double p10 = total_0 > 0.0 ? flips_0[q] / total_0 : 0.0;
+        double p01 = total_1 > 0.0 ? flips_1[q] / total_1 : 0.0;
+        calibration[q] = {{{1.0 - p10, p01}, {p10, 1.0 - p01}}};
+        if (std::min(1.0 - p10, 1.0 - p01) < mitigation::min_assignment_diagonal) {
+            throw std::runtime_error(
+                "readout calibration of qubit " + std::to_string(q) +
+                " is singular: P(0|0) = " + std::to_string(1.0 - p10) +
+                ", P(1|1) = " + std::to_string(1.0 - p01)
+            );
+        }
+    }
+    return calibration;
+}
+
+// Corrects measured counts for readout errors in the subspace of observed
+// bitstrings (matrix-free measurement mitigation, M3).
+//
+// The assignment matrix is restricted to the observed bitstrings and to pairs
+// within the Hamming-distance cutoff, with each column renormalized over the
+// subspace. Its entries are products of the per-qubit matrices; relative to the
+// diagonal only the differing qubits need to be visited. The partners of a row
+// are found by enumerating its Hamming ball and looking the bitstrings up in a
+// hash table, or, when the ball holds more bitstrings than were observed, by
+// comparing with every observed bitstring. Rows are assembled in parallel and
+// the sparse system A x = p is solved with Jacobi-preconditioned BiCGSTAB,
+// whose row-major sparse products Eigen runs with OpenMP.
+MitigationResult mitigate_readout(
+    const std::unordered_map<std::string, uint64_t> &counts,
+    const std::vector<AssignmentMatrix> &calibration, const ReadoutMitigation &settings
+)
+{
+    MitigationResult result;
+    if (counts.empty()) {
+        return result;
+    }
+
+    std::vector<std::string> bitstrings;
+    bitstrings.reserve(counts.size());
+    Eigen::VectorXd probs(static_cast<Eigen::Index>(counts.size()));
+    double total = 0.0;
+    for (const auto &[bitstring, count] : counts) {
+        mitigation::check_width(bitstring, calibration.size());
+        probs(static_cast<Eigen::Index>(bitstrings.size())) =
+            static_cast<double>(count);
+        bitstrings.push_back(bitstring);
+        total += static_cast<double>(count);
+    }
+    probs /= total;
+
+    const auto n = static_cast<int64_t>(bitstrings.size());
+    const size_t num_qubits = calibration.size();
+    std::vector<std::vector<uint64_t>> packed(n);
+    std::vector<double> diagonal(n);
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < n; ++i) {
+        packed[i] = mitigation::pack_bitstring(bitstrings[i]);
+        double value = 1.0;
+        for (size_t q = 0; q < num_qubits; ++q) {
+            int bit = static_cast<int>((packed[i][q / 64] >> (q % 64)) & 1ULL);
+            value *= calibration[q][bit][bit];
+        }
+        diagonal[i] = value;
+    }
+
+    // A(i, j) = P(measure i | prepare j) for j within the cutoff of i.
+    auto entry = [&](int64_t i, int64_t j) {
+        double value = diagonal[j];
+        for (size_t w = 0; w < packed[i].size(); ++w) {
+            uint64_t diff = packed[i][w] ^ packed[j][w];
+            while (diff != 0) {
+                size_t q = w * 64 + static_cast<size_t>(__builtin_ctzll(diff));
+                int bit_i = static_cast<int>((packed[i][w] >> (q % 64)) & 1ULL);
+                int bit_j = 1 - bit_i;
+                value *= calibration[q][bit_i][bit_j] / calibration[q][bit_j][bit_j];
+                diff &= diff - 1;
+            }
+        }
+        return value;
+    };
+
+    std::vector<std::vector<std::pair<int64_t, double>>> rows(n);
+    const bool enumerate = mitigation::hamming_ball_size(
+                               num_qubits, settings.distance, static_cast<uint64_t>(n)
+                           ) < static_cast<uint64_t>(n);
+    if (enumerate) {
+        std::unordered_map<std::vector<uint64_t>, int64_t, mitigation::PackedHash>
+            index;
+        index.reserve(static_cast<size_t>(n));
+        for (int64_t i = 0; i < n; ++i) {
+            index.emplace(packed[i], i);
+        }
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < n; ++i) {
+            std::vector<uint64_t> neighbor = packed[i];
+            mitigation::for_each_in_hamming_ball(
+                neighbor, num_qubits, settings.distance, 0,
+                [&](const std::vector<uint64_t> &bits) {
+                    auto it = index.find(bits);
+                    if (it != index.end()) {
+                        rows[i].emplace_back(it->second, entry(i, it->second));
+                    }
+                }
+            );
+            std::sort(rows[i].begin(), rows[i].end());
+        }
+    } else {
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < n; ++i) {
+            for (int64_t j = 0; j < n; ++j) {
+                int distance = 0;
+                for (size_t w = 0; w < packed[i].size(); ++w) {
+                    distance += static_cast<int>(
+                        std::bitset<64>(packed[i][w] ^ packed[j][w]).count()
+                    );
+                }
+                if (distance <= settings.distance) {
+                    rows[i].emplace_back(j, entry(i, j));
+                }
+            }
+        }
+    }
+
+    std::vector<double> column_sums(n, 0.0);
+    for (const auto &row : rows) {
+        for (const auto &[j, value] : row) {
+            column_sums[j] += value;
+        }
+    }
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int64_t i = 0; i < n; ++i) {
+        for (const auto &[j, value] : rows[i]) {
+            triplets.emplace_back(i, j, value / column_sums[j]);
+        }
+        std::vector<std::pair<int64_t, double>>().swap(rows[i]);
+    }
+    Eigen::SparseMatrix<double, Eigen::RowMajor> assignment(n, n);
+    assignment.setFromTriplets(triplets.begin(), triplets.end());
+
+    Eigen::BiCGSTAB<
+        Eigen::SparseMatrix<double, Eigen::RowMajor>,
+        Eigen::DiagonalPreconditioner<double>>
+        solver;
+    solver.setTolerance(settings.tol);
+    solver.setMaxIterations(settings.max_iterations);
+    solver.compute(assignment);
+    Eigen::VectorXd quasi = solver.solve(probs);
+    result.iterations = static_cast<int>(solver.iterations());
+    result.error = solver.error();
+
+    std::vector<double> values(quasi.data(), quasi.data() + n);
+    double sum = std::accumulate(values.begin(), values.end(), 0.0);
+    for (auto &value : values) {
+        value /= sum;
+    }
+    mitigation::nearest_probability_distribution(values);
+    for (int64_t i = 0; i < n; ++i) {
+        if (values[i] > 0.0) {
+            result.probabilities[bitstrings[i]] = values[i];
+        }
+    }
+    return result;
+}
+
+#endif // MITIGATION_HELPER_HPP_
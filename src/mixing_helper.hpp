@@ -0,0 +1,92 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef MIXING_HELPER_HPP_
+#define MIXING_HELPER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+
+#include <Eigen/Dense>
+
+// Settings of the occupancy mixing between configuration recovery iterations.
+struct OccupancyMixing {
+    bool enabled = false; // off feeds the SBD density straight back
+    int history = 5;      // previous iterations kept by the Anderson mixer
+    double damping = 0.5; // weight of the new density in each update
+};
+
+// Anderson (Pulay DIIS) acceleration of a fixed-point iteration x = F(x).
+//
+// With the residuals r_k = F(x_k) - x_k, the next input combines the last
+// history + 1 iterates with the coefficients that minimise the norm of the
+// linearly extrapolated residual, and then moves a fraction damping along that
+// residual. History 0 reduces to damped linear mixing, and damping 1 with
+// history 0 to the plain fixed-point iteration.
+class AndersonMixer
+{
+  public:
+    AndersonMixer(int history, double damping)
+      : history_(static_cast<size_t>(std::max(history, 0))), damping_(damping)
+    {
+    }
+
+    // Next input from the current input x and its image fx = F(x).
+    Eigen::VectorXd next(const Eigen::VectorXd &x, const Eigen::VectorXd &fx)
+    {
+        Eigen::VectorXd residual = fx - x;
+        if (previous_x_.size() == x.size() && history_ > 0) {
+            dx_.push_back(x - previous_x_);
+            dr_.push_back(residual - previous_residual_);
+            if (dx_.size() > history_) {
+                dx_.pop_front();
+                dr_.pop_front();
+            }
+        }
+        previous_x_ = x;
+        previous_residual_ = residual;
+
+        Eigen::VectorXd update = x + damping_ * residual;
+        if (!dx_.empty()) {
+            const auto m = static_cast<Eigen::Index>(dx_.size());
+            Eigen::MatrixXd dx(x.size(), m), dr(x.size(), m);
+            for (Eigen::Index j = 0; j < m; ++j) {
+                dx.col(j) = dx_[j];
+                dr.col(j) = dr_[j];
+            }
+            // Rank-revealing solve, as nearly repeated residuals make the
+            // differences collinear.
+            Eigen::VectorXd gamma =
+                dr.completeOrthogonalDecomposition().solve(residual);
+            update -= (dx + damping_ * dr) * gamma;
+        }
+        return update;
+    }
+
+    size_t history_size() const
+    {
+        return dx_.size();
+    }
+
+  private:
+    size_t history_;
+    double damping_;
+    Eigen::VectorXd previous_x_;
+    Eigen::VectorXd previous_residual_;
+    std::deque<Eigen::VectorXd> dx_; // differences of successive inputs
+    std::deque<Eigen::VectorXd> dr_; // differences of successive residuals
+};
+
+#endif // MIXING_HELPER_HPP_
@@ -0,0 +1,291 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef PARTITION_HELPER_HPP_
+#define PARTITION_HELPER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <numeric>
+#include <vector>
+
+#include "determinant_index_helper.hpp"
+
+// Number of strings connected to each string of the determinant space, the
+// string itself included.
+struct ConnectionCounts {
+    std::vector<double> singles; // within one excitation
+    std::vector<double> doubles; // within two excitations
+};
+
+// Estimated Hamiltonian-vector product cost of the W blocks owned by the ranks
+// of b_comm, for a given string order and partition.
+struct LoadEstimate {
+    double max_cost = 0.0;
+    double mean_cost = 0.0;
+
+    double imbalance() const
+    {
+        return mean_cost > 0.0 ? max_cost / mean_cost : 1.0;
+    }
+};
+
+namespace partition
+{
+
+// Packs strings decoded with one orbital per element into words of 64 bits,
+// bit j of the packed string holding orbital order[j].
+inline std::vector<uint64_t> pack_strings(
+    const std::vector<std::vector<size_t>> &dets, const std::vector<size_t> &order
+)
+{
+    const size_t words = (order.size() + 63) / 64;
+    std::vector<uint64_t> packed(dets.size() * words, 0);
+    for (size_t i = 0; i < dets.size(); ++i) {
+        for (size_t j = 0; j < order.size(); ++j) {
+            if (dets[i][order[j]] != 0) {
+                packed[i * words + j / 64] |= 1ULL << (j % 64);
+            }
+        }
+    }
+    return packed;
+}
+
+// Relabels orbitals of strings decoded with one orbital per element.
+inline void permute_orbitals(
+    std::vector<std::vector<size_t>> &dets, const std::vector<size_t> &order
+)
+{
+    for (auto &det : dets) {
+        std::vector<size_t> permuted(order.size());
+        for (size_t j = 0; j < order.size(); ++j) {
+            permuted[j] = det[order[j]];
+        }
+        det.swap(permuted);
+    }
+}
+
+// Positions of the packed strings after a lexicographic sort, most significant
+// word and bit last, as done by sbd::sort_bitarray.
+inline std::vector<size_t>
+sorted_positions(const std::vector<uint64_t> &packed, size_t words)
+{
+    std::vector<size_t> index(packed.size() / words);
+    std::iota(index.begin(), index.end(), 0);
+    std::sort(index.begin(), index.end(), [&](size_t a, size_t b) {
+        for (size_t w = words; w-- > 0;) {
+            if (packed[a * words + w] != packed[b * words + w]) {
+                return packed[a * words + w] < packed[b * words + w];
+            }
+        }
+        return false;
+    });
+    return index;
+}
+
+// Contiguous split of n items into parts of equal count, the first n % parts
+// parts taking one extra item.
+inline std::vector<size_t> even_boundaries(size_t n, int parts)
+{
+    std::vector<size_t> bounds(parts + 1, 0);
+    for (int k = 0; k < parts; ++k) {
+        bounds[k + 1] = bounds[k] + n / parts + (static_cast<size_t>(k) < n % parts);
+    }
+    return bounds;
+}
+
+// Counts, for each packed string, itself and those of its single and double
+// excitations within norb orbitals for which found() reports a string of the
+// space. found(candidates, count) returns how many of count candidates, words
+// words each, are in the space.
+template <typename Found>
+ConnectionCounts count_excitations(
+    const std::vector<uint64_t> &packed, size_t norb, const Found &found
+)
+{
+    const size_t words = (norb + 63) / 64;
+    const auto n = static_cast<int64_t>(packed.size() / words);
+    ConnectionCounts counts{std::vector<double>(n), std::vector<double>(n)};
+#pragma omp parallel
+    {
+        std::vector<size_t> occupied;
+        std::vector<size_t> virtuals;
+        std::vector<uint64_t> candidates;
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < n; ++i) {
+            const uint64_t *str = &packed[i * words];
+            occupied.clear();
+            virtuals.clear();
+            for (size_t p = 0; p < norb; ++p) {
+                ((str[p / 64] >> (p % 64)) & 1 ? occupied : virtuals).push_back(p);
+            }
+            auto flip = [&](uint64_t *candidate, size_t p) {
+                candidate[p / 64] ^= 1ULL << (p % 64);
+            };
+            auto push = [&](std::initializer_list<size_t> orbitals) {
+                const size_t offset = candidates.size();
+                candidates.insert(candidates.end(), str, str + words);
+                for (size_t p : orbitals) {
+                    flip(&candidates[offset], p);
+                }
+            };
+
+            candidates.clear();
+            for (size_t a : occupied) {
+                for (size_t r : virtuals) {
+                    push({a, r});
+                }
+            }
+            const size_t singles =
+                1 + found(candidates.data(), candidates.size() / words);
+
+            candidates.clear();
+            for (size_t x = 0; x < occupied.size(); ++x) {
+                for (size_t y = x + 1; y < occupied.size(); ++y) {
+                    for (size_t r = 0; r < virtuals.size(); ++r) {
+                        for (size_t t = r + 1; t < virtuals.size(); ++t) {
+                            push({occupied[x], occupied[y], virtuals[r], virtuals[t]});
+                        }
+                    }
+                }
+            }
+            const size_t doubles =
+                singles + found(candidates.data(), candidates.size() / words);
+
+            counts.singles[i] = static_cast<double>(singles);
+            counts.doubles[i] = static_cast<double>(doubles);
+        }
+    }
+    return counts;
+}
+
+} // namespace partition
+
+// Counts the strings within one and two excitations of every string by
+// enumerating its excitations and looking them up among the strings: a
+// DeterminantIndex when they fit in one word, a binary search over their sorted
+// order otherwise. The cost is linear in the number of strings.
+ConnectionCounts connection_counts(const std::vector<uint64_t> &packed, size_t norb)
+{
+    const size_t words = (norb + 63) / 64;
+    if (words == 1) {
+        std::vector<uint64_t> sorted(packed);
+        std::sort(sorted.begin(), sorted.end());
+        const DeterminantIndex index(sorted);
+        return partition::count_excitations(
+            packed, norb,
+            [&](const uint64_t *candidates, size_t count) {
+                std::vector<size_t> positions(count);
+                index.find(candidates, count, positions.data());
+                return static_cast<size_t>(std::count_if(
+                    positions.begin(), positions.end(),
+                    [](size_t position) { return position != DeterminantIndex::npos; }
+                ));
+            }
+        );
+    }
+
+    // Lexicographic order of the strings, most significant word last.
+    auto less = [words](const uint64_t *a, const uint64_t *b) {
+        for (size_t w = words; w-- > 0;) {
+            if (a[w] != b[w]) {
+                return a[w] < b[w];
+            }
+        }
+        return false;
+    };
+    std::vector<const uint64_t *> sorted;
+    for (auto position : partition::sorted_positions(packed, words)) {
+        sorted.push_back(&packed[position * words]);
+    }
+    return partition::count_excitations(
+        packed, norb,
+        [&](const uint64_t *candidates, size_t count) {
+            size_t hits = 0;
+            for (size_t k = 0; k < count; ++k) {
+                const uint64_t *candidate = candidates + k * words;
+                auto it =
+                    std::lower_bound(sorted.begin(), sorted.end(), candidate, less);
+                hits += it != sorted.end() && !less(candidate, *it);
+            }
+            return hits;
+        }
+    );
+}
+
+// Orbital order that clusters strings by occupation pattern under a
+// lexicographic sort. Orbitals are ranked by the variance f (1 - f) of their
+// occupation f over the strings, so that the most fluctuating orbitals become
+// the most significant bits: strings sharing their pattern end up contiguous and
+// the excitations of a block of strings reach few other blocks. Orbitals that
+// are always or never occupied keep the lowest labels.
+std::vector<size_t>
+cluster_orbital_order(const std::vector<std::vector<size_t>> &dets, size_t norb)
+{
+    std::vector<double> variance(norb, 0.0);
+    for (const auto &det : dets) {
+        for (size_t p = 0; p < norb; ++p) {
+            variance[p] += det[p] != 0 ? 1.0 : 0.0;
+        }
+    }
+    for (auto &v : variance) {
+        double f = dets.empty() ? 0.0 : v / static_cast<double>(dets.size());
+        v = f * (1.0 - f);
+    }
+    std::vector<size_t> order(norb);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return variance[a] < variance[b];
+    });
+    return order;
+}
+
+// Estimated cost of the W blocks of all b_comm ranks, alpha and beta strings
+// sharing the order given by position and split at the given boundaries.
+LoadEstimate estimate_load(
+    const ConnectionCounts &counts, const std::vector<size_t> &position,
+    const std::vector<size_t> &a_bounds, const std::vector<size_t> &b_bounds
+)
+{
+    auto slice_sums = [&](const std::vector<size_t> &bounds) {
+        std::vector<std::array<double, 3>> sums(bounds.size() - 1);
+        for (size_t k = 0; k + 1 < bounds.size(); ++k) {
+            double singles = 0.0;
+            double doubles = 0.0;
+            for (size_t x = bounds[k]; x < bounds[k + 1]; ++x) {
+                singles += counts.singles[position[x]];
+                doubles += counts.doubles[position[x]];
+            }
+            double size = static_cast<double>(bounds[k + 1] - bounds[k]);
+            sums[k] = {size, singles, doubles};
+        }
+        return sums;
+    };
+    auto a_sums = slice_sums(a_bounds);
+    auto b_sums = slice_sums(b_bounds);
+    LoadEstimate estimate;
+    for (const auto &a : a_sums) {
+        for (const auto &b : b_sums) {
+            double cost = b[0] * a[2] + a[0] * b[2] + a[1] * b[1];
+            estimate.max_cost = std::max(estimate.max_cost, cost);
+            estimate.mean_cost += cost;
+        }
+    }
+    estimate.mean_cost /= static_cast<double>(a_sums.size() * b_sums.size());
+    return estimate;
+}
+
+#endif // PARTITION_HELPER_HPP_
@@ -0,0 +1,558 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef PT2_HELPER_HPP_
+#define PT2_HELPER_HPP_
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "determinant_index_helper.hpp"
+#include "ffsim/fcidump.hpp"
+#include "mpi.h"
+
+// Settings of the Epstein-Nesbet PT2 stage.
+struct PT2 {
+    bool enabled = false;
+    // References with |c| >= eps_det are treated deterministically, the rest are
+    // sampled.
+    double eps_det = 1.0e-3;
+    // Contributions |<a|H|i> c_i| below eps are screened out.
+    double eps = 1.0e-8;
+    int num_samples = 10;         // number of independent stochastic estimates
+    uint64_t sample_size = 1000;  // references drawn per stochastic estimate
+    uint64_t batch_size = 100000; // references expanded between exchanges
+    // Integrals factorized to this tolerance before the broadcast; 0 keeps them
+    // dense. Each (pq|rs) then costs a sum over the Cholesky vectors.
+    double cholesky_tol = 0.0;
+    unsigned int seed = 1234;
+};
+
+// Second-order energy correction and the standard error of its stochastic part.
+struct PT2Result {
+    double energy = 0.0;
+    double error = 0.0;
+};
+
+namespace pt2
+{
+
+struct Determinant {
+    uint64_t alpha;
+    uint64_t beta;
+    bool operator==(const Determinant &other) const
+    {
+        return alpha == other.alpha && beta == other.beta;
+    }
+};
+
+struct DeterminantHash {
+    size_t operator()(const Determinant &det) const
+    {
+        uint64_t h = det.alpha * 0x9E3779B97F4A7C15ULL;
+        h ^= det.beta + 0x7F4A7C159E3779B9ULL + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+// Coupling <a|H|Psi> accumulated for one external determinant.
+// value holds the (weighted) sum and square the sum of squared terms, which the
+// stochastic estimator needs to remove its own bias.
+struct Contribution {
+    Determinant det;
+    double value;
+    double square;
+};
+
+using ContributionMap =
+    std::unordered_map<Determinant, std::pair<double, double>, DeterminantHash>;
+
+// Dense Coulomb J_pq = (pp|qq) and exchange K_pq = (pq|qp) integrals used by the
+// diagonal energies and the single excitations.
+struct Integrals {
+    const ffsim::FCIDump &fcidump;
+    Eigen::MatrixXd coulomb;
+    Eigen::MatrixXd exchange;
+
+    explicit Integrals(const ffsim::FCIDump &fcidump) : fcidump(fcidump)
+    {
+        const auto n = static_cast<Eigen::Index>(fcidump.norb);
+        coulomb.resize(n, n);
+        exchange.resize(n, n);
+        for (Eigen::Index p = 0; p < n; ++p) {
+            for (Eigen::Index q = 0; q < n; ++q) {
+                coulomb(p, q) = fcidump.two_body(p, p, q, q);
+                exchange(p, q) = fcidump.two_body(p, q, q, p);
+            }
+        }
+    }
+};
+
+inline std::vector<int> occupied_orbitals(uint64_t str)
+{
+    std::vector<int> occ;
+    while (str != 0) {
+        occ.push_back(__builtin_ctzll(str));
+        str &= str - 1;
+    }
+    return occ;
+}
+
+// Fermionic sign of a^dagger_q a_p acting on str: the parity of the occupied
+// orbitals strictly between p and q.
+inline double excitation_sign(uint64_t str, int p, int q)
+{
+    int lo = std::min(p, q);
+    int hi = std::max(p, q);
+    uint64_t mask = ((hi >= 64 ? ~0ULL : (1ULL << hi)) - 1) & ~((2ULL << lo) - 1);
+    return (__builtin_popcountll(str & mask) & 1) ? -1.0 : 1.0;
+}
+
+inline double determinant_energy(const Integrals &ints, uint64_t alpha, uint64_t beta)
+{
+    const auto occ_a = occupied_orbitals(alpha);
+    const auto occ_b = occupied_orbitals(beta);
+    double energy = ints.fcidump.constant;
+    for (int p : occ_a) {
+        energy += ints.fcidump.one_body(p, p);
+        for (int q : occ_a) {
+            energy += 0.5 * (ints.coulomb(p, q) - ints.exchange(p, q));
+        }
+        for (int q : occ_b) {
+            energy += ints.coulomb(p, q);
+        }
+    }
+    for (int p : occ_b) {
+        energy += ints.fcidump.one_body(p, p);
+        for (int q : occ_b) {
+            energy += 0.5 * (ints.coulomb(p, q) - ints.exchange(p, q));
+        }
+    }
+    return energy;
+}
+
+// <str'|H|str> for the single excitation p -> q in one spin sector, where `same`
+// is the string being excited and `other` the opposite-spin string.
+inline double single_excitation_element(
+    const Integrals &ints, uint64_t same, uint64_t other, int p, int q
+)
+{
+    const auto &f = ints.fcidump;
+    double value = f.one_body(q, p);
+    for (uint64_t str = same; str != 0; str &= str - 1) {
+        int k = __builtin_ctzll(str);
+        value += f.two_body(q, p, k, k) - f.two_body(q, k, k, p);
+    }
+    for (uint64_t str = other; str != 0; str &= str - 1) {
+        int k = __builtin_ctzll(str);
+        value += f.two_body(q, p, k, k);
+    }
+    return excitation_sign(same, p, q) * value;
+}
+
+// Calls emit(alpha', beta', <alpha' beta'|H|alpha beta>) for every determinant
+// connected to (alpha, beta) by H that lies outside the variational space.
+template <typename AlphaInSpace, typename BetaInSpace, typename Emit>
+void for_each_external(
+    const Integrals &ints, uint64_t alpha, uint64_t beta,
+    const AlphaInSpace &alpha_in_space, const BetaInSpace &beta_in_space,
+    const Emit &emit
+)
+{
+    const auto &f = ints.fcidump;
+    const int norb = static_cast<int>(f.norb);
+    const uint64_t full = (norb >= 64) ? ~0ULL : ((1ULL << norb) - 1);
+    const auto occ_a = occupied_orbitals(alpha);
+    const auto occ_b = occupied_orbitals(beta);
+    const auto vir_a = occupied_orbitals(~alpha & full);
+    const auto vir_b = occupied_orbitals(~beta & full);
+
+    // Singles and same-spin doubles. Only the excited string changes, so the
+    // determinant is external exactly when that string is outside its space.
+    auto same_spin = [&](uint64_t same, uint64_t other, const std::vector<int> &occ,
+                         const std::vector<int> &vir, const auto &in_space,
+                         bool is_alpha) {
+        for (int p : occ) {
+            for (int q : vir) {
+                uint64_t excited = same ^ (1ULL << p) ^ (1ULL << q);
+                if (!in_space(excited)) {
+                    double h = single_excitation_element(ints, same, other, p, q);
+                    is_alpha ? emit(excited, other, h) : emit(other, excited, h);
+                }
+            }
+        }
+        for (size_t i = 0; i < occ.size(); ++i) {
+            for (size_t j = i + 1; j < occ.size(); ++j) {
+                int p = occ[i];
+                int r = occ[j];
+                for (size_t k = 0; k < vir.size(); ++k) {
+                    for (size_t l = k + 1; l < vir.size(); ++l) {
+                        int q = vir[k];
+                        int s = vir[l];
+                        uint64_t first = same ^ (1ULL << p) ^ (1ULL << q);
+                        uint64_t excited = first ^ (1ULL << r) ^ (1ULL << s);
+                        if (in_space(excited)) {
+                            continue;
+                        }
+                        double h = excitation_sign(same, p, q) *
+                                   excitation_sign(first, r, s) *
+                                   (f.two_body(q, p, s, r) - f.two_body(q, r, s, p));
+                        is_alpha ? emit(excited, other, h) : emit(other, excited, h);
+                    }
+                }
+            }
+        }
+    };
+    same_spin(alpha, beta, occ_a, vir_a, alpha_in_space, true);
+    same_spin(beta, alpha, occ_b, vir_b, beta_in_space, false);
+
+    // Opposite-spin doubles.
+    for (int p : occ_a) {
+        for (int q : vir_a) {
+            uint64_t excited_a = alpha ^ (1ULL << p) ^ (1ULL << q);
+            bool alpha_inside = alpha_in_space(excited_a);
+            double sign_a = excitation_sign(alpha, p, q);
+            for (int r : occ_b) {
+                for (int s : vir_b) {
+                    uint64_t excited_b = beta ^ (1ULL << r) ^ (1ULL << s);
+                    if (alpha_inside && beta_in_space(excited_b)) {
+                        continue;
+                    }
+                    emit(
+                        excited_a, excited_b,
+                        sign_a * excitation_sign(beta, r, s) * f.two_body(q, p, s, r)
+                    );
+                }
+            }
+        }
+    }
+}
+
+// Packs the SBD determinant words (bit_length orbitals per word, lowest orbital in
+// the lowest bit of the first word) into a single 64-bit string. Throws if an
+// occupied orbital lies beyond the first 64.
+inline uint64_t to_uint64(const std::vector<size_t> &det, size_t bit_length)
+{
+    const size_t word_mask =
+        (bit_length >= 64) ? ~size_t(0) : ((size_t(1) << bit_length) - 1);
+    uint64_t str = 0;
+    for (size_t w = 0; w < det.size(); ++w) {
+        const auto bits = static_cast<uint64_t>(det[w] & word_mask);
+        if (bits == 0) {
+            continue;
+        }
+        const size_t shift = w * bit_length;
+        if (shift >= 64 || (shift > 0 && (bits >> (64 - shift)) != 0)) {
+            throw std::invalid_argument("determinant has more than 64 orbitals");
+        }
+        str |= bits << shift;
+    }
+    return str;
+}
+
+// MPI_Bcast of size doubles in chunks below the int count limit.
+inline void bcast_doubles(double *data, uint64_t size, int root, MPI_Comm comm)
+{
+    constexpr uint64_t chunk = INT_MAX / 2;
+    for (uint64_t offset = 0; offset < size; offset += chunk) {
+        int count = static_cast<int>(std::min(chunk, size - offset));
+        MPI_Bcast(data + offset, count, MPI_DOUBLE, root, comm);
+    }
+}
+
+// Broadcasts integrals loaded on root to all ranks of comm, in their packed or
+// their factorized form.
+inline void bcast_fcidump(ffsim::FCIDump &fcidump, int root, MPI_Comm comm)
+{
+    uint64_t header[5] = {
+        fcidump.norb, fcidump.nelec, fcidump.orbsym.size(), fcidump.eri.size(),
+        fcidump.cholesky_vecs.size()
+    };
+    MPI_Bcast(header, 5, MPI_UINT64_T, root, comm);
+    MPI_Bcast(&fcidump.ms2, 1, MPI_INT64_T, root, comm);
+    MPI_Bcast(&fcidump.constant, 1, MPI_DOUBLE, root, comm);
+    fcidump.norb = header[0];
+    fcidump.nelec = header[1];
+    fcidump.orbsym.resize(header[2]);
+    const auto n = static_cast<Eigen::Index>(fcidump.norb);
+    fcidump.one_body.resize(n, n);
+    fcidump.eri.resize(header[3]);
+    fcidump.cholesky_vecs.resize(header[4]);
+    MPI_Bcast(fcidump.orbsym.data(), static_cast<int>(header[2]), MPI_INT, root, comm);
+    bcast_doubles(fcidump.one_body.data(), n * n, root, comm);
+    bcast_doubles(fcidump.eri.data(), fcidump.eri.size(), root, comm);
+    for (auto &vec : fcidump.cholesky_vecs) {
+        vec.resize(n, n);
+        bcast_doubles(vec.data(), n * n, root, comm);
+    }
+}
+
+// Sends every contribution to the rank owning its determinant and returns the
+// contributions received by this rank. The exchange runs in rounds of at most
+// chunk contributions per pair of ranks, which keeps the byte counts and
+// displacements of MPI_Alltoallv below the int limit however large the batch.
+inline std::vector<Contribution>
+exchange_contributions(const ContributionMap &local, MPI_Comm comm)
+{
+    int mpi_size;
+    MPI_Comm_size(comm, &mpi_size);
+    DeterminantHash hasher;
+
+    std::vector<std::vector<Contribution>> outgoing(mpi_size);
+    for (const auto &[det, value] : local) {
+        outgoing[hasher(det) % mpi_size].push_back({det, value.first, value.second});
+    }
+    const size_t chunk =
+        INT_MAX / sizeof(Contribution) / static_cast<size_t>(mpi_size);
+    uint64_t rounds = 0;
+    for (const auto &out : outgoing) {
+        rounds = std::max<uint64_t>(rounds, (out.size() + chunk - 1) / chunk);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &rounds, 1, MPI_UINT64_T, MPI_MAX, comm);
+
+    std::vector<int> send_counts(mpi_size), send_displs(mpi_size);
+    std::vector<int> recv_counts(mpi_size), recv_displs(mpi_size);
+    std::vector<Contribution> send_buffer, incoming;
+    for (uint64_t round = 0; round < rounds; ++round) {
+        send_buffer.clear();
+        for (int r = 0; r < mpi_size; ++r) {
+            const size_t begin = std::min(outgoing[r].size(), round * chunk);
+            const size_t end = std::min(outgoing[r].size(), begin + chunk);
+            send_displs[r] =
+                static_cast<int>(send_buffer.size() * sizeof(Contribution));
+            send_counts[r] = static_cast<int>((end - begin) * sizeof(Contribution));
+            send_buffer.insert(
+                send_buffer.end(), outgoing[r].begin() + begin,
+                outgoing[r].begin() + end
+            );
+        }
+        MPI_Alltoall(
+            send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, comm
+        );
+        int recv_total = 0;
+        for (int r = 0; r < mpi_size; ++r) {
+            recv_displs[r] = recv_total;
+            recv_total += recv_counts[r];
+        }
+        const size_t offset = incoming.size();
+        incoming.resize(offset + recv_total / sizeof(Contribution));
+        MPI_Alltoallv(
+            send_buffer.data(), send_counts.data(), send_displs.data(), MPI_BYTE,
+            incoming.data() + offset, recv_counts.data(), recv_displs.data(),
+            MPI_BYTE, comm
+        );
+    }
+    return incoming;
+}
+
+} // namespace pt2
+
+/**
+   Semistochastic Epstein-Nesbet second-order correction.
+
+   E2 = sum_a |<a|H|Psi>|^2 / (E0 - H_aa) over determinants a outside the
+   variational space. Psi is split into Psi_D (|c| >= eps_det) and Psi_S. The
+   Psi_D couplings are summed exactly; the cross and Psi_S terms are estimated from
+   num_samples multinomial draws of sample_size references with p_i ~ |c_i|, using
+   the unbiased estimator of the squared coupling
+       V_a^2 ~ N / (N - 1) * (Y_a^2 - sum_i n_i z_i^2),  z_i = c_i H_ai / (N p_i).
+
+   The coefficients W are the local block of the SBD wavefunction: alpha strings
+   [a_begin, a_end) x beta strings [b_begin, b_end), beta index fastest. Ranks
+   holding replicas of the same block split it by p_rank / p_size. External
+   determinants are owned by rank hash(det) % size of comm.
+*/
+PT2Result epstein_nesbet_pt2(
+    const ffsim::FCIDump &fcidump, double e0, const std::vector<uint64_t> &alpha_strs,
+    const std::vector<uint64_t> &beta_strs, const std::vector<double> &W,
+    size_t a_begin, size_t a_end, size_t b_begin, size_t b_end, int p_rank, int p_size,
+    const PT2 &settings, MPI_Comm comm
+)
+{
+    using namespace pt2;
+    if (fcidump.norb > 64) {
+        throw std::invalid_argument("PT2 supports at most 64 orbitals");
+    }
+    int mpi_rank;
+    MPI_Comm_rank(comm, &mpi_rank);
+    int mpi_size;
+    MPI_Comm_size(comm, &mpi_size);
+
+    Integrals ints(fcidump);
+    std::vector<uint64_t> sorted_a(alpha_strs), sorted_b(beta_strs);
+    std::sort(sorted_a.begin(), sorted_a.end());
+    std::sort(sorted_b.begin(), sorted_b.end());
+    // Every external determinant probes both lists.
+    const DeterminantIndex alpha_index(sorted_a), beta_index(sorted_b);
+    auto alpha_in_space = [&](uint64_t str) { return alpha_index.contains(str); };
+    auto beta_in_space = [&](uint64_t str) { return beta_index.contains(str); };
+
+    // References handled by this rank, split into the deterministic and the
+    // stochastic part.
+    const size_t b_size = b_end - b_begin;
+    std::vector<size_t> det_refs, stoch_refs;
+    for (size_t k = p_rank; k < W.size(); k += p_size) {
+        (std::abs(W[k]) >= settings.eps_det ? det_refs : stoch_refs).push_back(k);
+    }
+    auto reference = [&](size_t k) {
+        return Determinant{
+            alpha_strs[a_begin + k / b_size], beta_strs[b_begin + k % b_size]
+        };
+    };
+
+    // Deterministic part, expanded in batches to bound the message size.
+    ContributionMap owned;
+    uint64_t num_batches =
+        (det_refs.size() + settings.batch_size - 1) / settings.batch_size;
+    MPI_Allreduce(MPI_IN_PLACE, &num_batches, 1, MPI_UINT64_T, MPI_MAX, comm);
+    for (uint64_t batch = 0; batch < num_batches; ++batch) {
+        ContributionMap local;
+        size_t begin = std::min(det_refs.size(), batch * settings.batch_size);
+        size_t end = std::min(det_refs.size(), begin + settings.batch_size);
+        for (size_t idx = begin; idx < end; ++idx) {
+            double c = W[det_refs[idx]];
+            auto ref = reference(det_refs[idx]);
+            for_each_external(
+                ints, ref.alpha, ref.beta, alpha_in_space, beta_in_space,
+                [&](uint64_t alpha, uint64_t beta, double h) {
+                    if (std::abs(h * c) >= settings.eps) {
+                        local[{alpha, beta}].first += h * c;
+                    }
+                }
+            );
+        }
+        for (const auto &contribution : exchange_contributions(local, comm)) {
+            owned[contribution.det].first += contribution.value;
+        }
+    }
+
+    std::unordered_map<Determinant, double, DeterminantHash> denominators;
+    auto denominator = [&](const Determinant &det) {
+        auto it = denominators.find(det);
+        if (it == denominators.end()) {
+            it = denominators
+                     .emplace(det, e0 - determinant_energy(ints, det.alpha, det.beta))
+                     .first;
+        }
+        return it->second;
+    };
+
+    double e2_det = 0.0;
+    for (const auto &[det, value] : owned) {
+        e2_det += value.first * value.first / denominator(det);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &e2_det, 1, MPI_DOUBLE, MPI_SUM, comm);
+
+    PT2Result result;
+    result.energy = e2_det;
+
+    // Stochastic part.
+    double local_weight = 0.0;
+    for (auto k : stoch_refs) {
+        local_weight += std::abs(W[k]);
+    }
+    std::vector<double> rank_weights(mpi_size);
+    MPI_Allgather(
+        &local_weight, 1, MPI_DOUBLE, rank_weights.data(), 1, MPI_DOUBLE, comm
+    );
+    double total_weight =
+        std::accumulate(rank_weights.begin(), rank_weights.end(), 0.0);
+    if (total_weight == 0.0 || settings.num_samples < 2 || settings.sample_size < 2) {
+        return result;
+    }
+
+    std::vector<double> local_probs(stoch_refs.size());
+    for (size_t i = 0; i < stoch_refs.size(); ++i) {
+        local_probs[i] = std::abs(W[stoch_refs[i]]);
+    }
+    // Every rank draws the same split of the samples over ranks, then its own
+    // samples with a rank-dependent stream.
+    std::mt19937_64 shared_rng(settings.seed);
+    std::mt19937_64 local_rng(settings.seed + 1 + static_cast<uint64_t>(mpi_rank));
+    std::discrete_distribution<int> pick_rank(rank_weights.begin(), rank_weights.end());
+    const double n_total = static_cast<double>(settings.sample_size);
+
+    std::vector<double> estimates;
+    for (int sample = 0; sample < settings.num_samples; ++sample) {
+        uint64_t n_local = 0;
+        for (uint64_t draw = 0; draw < settings.sample_size; ++draw) {
+            n_local += (pick_rank(shared_rng) == mpi_rank) ? 1 : 0;
+        }
+        std::unordered_map<size_t, uint64_t> drawn;
+        if (n_local > 0) {
+            std::discrete_distribution<size_t> pick_ref(
+                local_probs.begin(), local_probs.end()
+            );
+            for (uint64_t draw = 0; draw < n_local; ++draw) {
+                ++drawn[pick_ref(local_rng)];
+            }
+        }
+
+        ContributionMap local;
+        for (const auto &[idx, count] : drawn) {
+            double c = W[stoch_refs[idx]];
+            double p = std::abs(c) / total_weight;
+            double n_i = static_cast<double>(count);
+            auto ref = reference(stoch_refs[idx]);
+            for_each_external(
+                ints, ref.alpha, ref.beta, alpha_in_space, beta_in_space,
+                [&](uint64_t alpha, uint64_t beta, double h) {
+                    if (std::abs(h * c) >= settings.eps) {
+                        double z = c * h / (n_total * p);
+                        auto &entry = local[{alpha, beta}];
+                        entry.first += n_i * z;
+                        entry.second += n_i * z * z;
+                    }
+                }
+            );
+        }
+
+        ContributionMap sampled;
+        for (const auto &contribution : exchange_contributions(local, comm)) {
+            auto &entry = sampled[contribution.det];
+            entry.first += contribution.value;
+            entry.second += contribution.square;
+        }
+        double estimate = 0.0;
+        for (const auto &[det, value] : sampled) {
+            auto it = owned.find(det);
+            double v_det = (it == owned.end()) ? 0.0 : it->second.first;
+            double square = n_total / (n_total - 1.0) *
+                            (value.first * value.first - value.second);
+            estimate += (2.0 * v_det * value.first + square) / denominator(det);
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &estimate, 1, MPI_DOUBLE, MPI_SUM, comm);
+        estimates.push_back(estimate);
+    }
+
+    double mean = std::accumulate(estimates.begin(), estimates.end(), 0.0) /
+                  static_cast<double>(estimates.size());
+    double variance = 0.0;
+    for (double estimate : estimates) {
+        variance += (estimate - mean) * (estimate - mean);
+    }
+    variance /= static_cast<double>(estimates.size() - 1);
+    result.energy += mean;
+    result.error = std::sqrt(variance / static_cast<double>(estimates.size()));
+    return result;
+}
+
+#endif
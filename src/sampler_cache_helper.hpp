@@ -0,0 +1,202 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#ifndef SAMPLER_CACHE_HELPER_HPP_
+#define SAMPLER_CACHE_HELPER_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "counts_helper.hpp"
+#include "input_helper.hpp"
+
+// Everything that determines the shot distribution of one sampler pub.
+struct SamplerCacheKey {
+    std::string circuit; // transpiled circuit, as OpenQASM 3
+    std::string backend;
+    uint64_t shots = 0;
+};
+
+namespace sampler_cache
+{
+
+constexpr char file_magic[8] = {'S', 'Q', 'D', 'S', 'H', 'O', 'T', 'S'};
+constexpr uint64_t file_version = 1;
+
+// 64-bit FNV-1a of size bytes, continuing from hash.
+inline uint64_t
+fnv1a(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL)
+{
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+inline uint64_t circuit_hash(const SamplerCacheKey &key)
+{
+    return fnv1a(key.circuit.data(), key.circuit.size());
+}
+
+// Hash of the whole key; names the cache file.
+inline uint64_t key_hash(const SamplerCacheKey &key)
+{
+    uint64_t hash = circuit_hash(key);
+    hash = fnv1a(key.backend.data(), key.backend.size() + 1, hash);
+    return fnv1a(&key.shots, sizeof(key.shots), hash);
+}
+
+} // namespace sampler_cache
+
+// Local store of sampler results, one file per pub named by the hash of its key,
+// so that a run repeating an earlier job reads the shots instead of resubmitting.
+//
+// A file holds the key fields it was written for (backend, shots, circuit hash
+// and length), checked on every read so that a hash collision or a file of
+// another version reads as a miss, followed by the packed counts in first-seen
+// order; the histogram read back is the one that was stored, entry for entry.
+class SamplerCache
+{
+  public:
+    // Caches in directory, created on the first store. With read false every
+    // lookup misses and new results replace the stored ones; an empty directory
+    // disables the cache.
+    SamplerCache(std::string directory, bool read)
+      : directory_(std::move(directory)), read_(read)
+    {
+    }
+
+    bool enabled() const
+    {
+        return !directory_.empty();
+    }
+
+    std::string path(const SamplerCacheKey &key) const
+    {
+        char name[17];
+        std::snprintf(
+            name, sizeof(name), "%016llx",
+            static_cast<unsigned long long>(sampler_cache::key_hash(key))
+        );
+        return (std::filesystem::path(directory_) / (std::string(name) + ".shots"))
+            .string();
+    }
+
+    // Adds the stored shots of key to counts, an empty table. Returns false,
+    // leaving counts untouched, if there are none.
+    bool load(const SamplerCacheKey &key, PackedCounts &counts) const
+    {
+        if (!enabled() || !read_) {
+            return false;
+        }
+        std::ifstream file(path(key), std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::vector<char> blob(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(blob.data(), static_cast<std::streamsize>(blob.size()));
+        try {
+            input::BlobReader reader(blob);
+            char magic[sizeof(sampler_cache::file_magic)];
+            uint64_t version = 0, shots = 0, hash = 0, length = 0, num_bits = 0;
+            std::vector<char> backend;
+            reader.read(magic, sizeof(magic));
+            reader.read(&version, sizeof(version));
+            if (!std::equal(
+                    std::begin(magic), std::end(magic), sampler_cache::file_magic
+                ) ||
+                version != sampler_cache::file_version) {
+                return false;
+            }
+            reader.read_array(backend);
+            reader.read(&shots, sizeof(shots));
+            reader.read(&hash, sizeof(hash));
+            reader.read(&length, sizeof(length));
+            reader.read(&num_bits, sizeof(num_bits));
+            if (std::string(backend.begin(), backend.end()) != key.backend ||
+                shots != key.shots || hash != sampler_cache::circuit_hash(key) ||
+                length != key.circuit.size() || num_bits != counts.num_bits()) {
+                return false;
+            }
+            std::vector<uint64_t> keys, key_counts;
+            reader.read_array(keys);
+            reader.read_array(key_counts);
+            if (keys.size() != key_counts.size() * counts.words()) {
+                return false;
+            }
+            for (size_t i = 0; i < key_counts.size(); ++i) {
+                counts.add(&keys[i * counts.words()], key_counts[i]);
+            }
+        } catch (const std::runtime_error &) {
+            return false; // truncated file
+        }
+        return true;
+    }
+
+    // Stores counts as the shots of key, replacing any earlier entry. The file is
+    // written next to its final name and renamed, so readers never see it half
+    // written.
+    void store(const SamplerCacheKey &key, const PackedCounts &counts) const
+    {
+        if (!enabled()) {
+            return;
+        }
+        std::vector<char> blob;
+        const uint64_t hash = sampler_cache::circuit_hash(key);
+        const uint64_t length = key.circuit.size();
+        const uint64_t num_bits = counts.num_bits();
+        input::append_bytes(
+            blob, sampler_cache::file_magic, sizeof(sampler_cache::file_magic)
+        );
+        input::append_bytes(
+            blob, &sampler_cache::file_version, sizeof(sampler_cache::file_version)
+        );
+        input::append_array(
+            blob, std::vector<char>(key.backend.begin(), key.backend.end())
+        );
+        input::append_bytes(blob, &key.shots, sizeof(key.shots));
+        input::append_bytes(blob, &hash, sizeof(hash));
+        input::append_bytes(blob, &length, sizeof(length));
+        input::append_bytes(blob, &num_bits, sizeof(num_bits));
+        input::append_array(blob, counts.keys());
+        input::append_array(blob, counts.key_counts());
+
+        std::filesystem::create_directories(directory_);
+        const std::string target = path(key);
+        const std::string partial = target + ".partial";
+        {
+            std::ofstream file(partial, std::ios::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Could not open file: " + partial);
+            }
+            file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+        }
+        std::filesystem::rename(partial, target);
+    }
+
+  private:
+    std::string directory_;
+    bool read_;
+};
+
+#endif // SAMPLER_CACHE_HELPER_HPP_
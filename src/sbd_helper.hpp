@@ -29,7 +29,12 @@
 #define USE_MATH_DEFINES
 #include <cmath>
 
+#include "davidson_helper.hpp"
+#include "ffsim/fcidump.hpp"
+#include "memory_helper.hpp"
 #include "mpi.h"
+#include "partition_helper.hpp"
+#include "pt2_helper.hpp"
 #include "sbd/sbd.h"
 
 struct SBD {
@@ -44,6 +49,9 @@ struct SBD {
     double max_time = 600.0;
     int init = 0;
 
+    // Number of lowest eigenstates; more than one switches to block Davidson
+    int num_roots = 1;
+
     double threshold = 0.0;
 
     // This default value is for the Fe4S4
@@ -52,6 +60,19 @@ struct SBD {
 
     std::string adetfile = "AlphaDets.bin";
     std::string fcidumpfile = "";
+
+    // Orbital relabeling applied to the determinant strings before they are
+    // sorted and split over adet_comm/bdet_comm: "lex" keeps the input labels,
+    // "cluster" groups strings by occupation pattern, "auto" picks whichever of
+    // the two gives the lower estimated load imbalance. Only the order changes;
+    // SBD still splits the sorted strings into parts of equal count.
+    std::string det_ordering = "lex";
+
+    // Page placement of W, hii and C: "default", "first_touch" or "huge_pages"
+    std::string page_placement = "default";
+
+    // Epstein-Nesbet PT2 correction evaluated after the diagonalization
+    PT2 pt2;
 };
 
 SBD generate_sbd_data(int argc, char *argv[])
@@ -78,6 +99,10 @@ SBD generate_sbd_data(int argc, char *argv[])
             sbd.max_time = std::atof(argv[i + 1]);
             i++;
         }
+        if (std::string(argv[i]) == "--num_roots") {
+            sbd.num_roots = std::atoi(argv[i + 1]);
+            i++;
+        }
         if (std::string(argv[i]) == "--adet_comm_size") {
             sbd.adet_comm_size = std::atoi(argv[i + 1]);
             i++;
@@ -98,13 +123,170 @@ SBD generate_sbd_data(int argc, char *argv[])
             sbd.init = std::atoi(argv[i + 1]);
             i++;
         }
+        if (std::string(argv[i]) == "--det_ordering") {
+            sbd.det_ordering = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--page_placement") {
+            sbd.page_placement = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--pt2") {
+            sbd.pt2.enabled = true;
+        }
+        if (std::string(argv[i]) == "--pt2_eps_det") {
+            sbd.pt2.eps_det = std::atof(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--pt2_eps") {
+            sbd.pt2.eps = std::atof(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--pt2_samples") {
+            sbd.pt2.num_samples = std::atoi(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--pt2_sample_size") {
+            sbd.pt2.sample_size = std::stoull(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--pt2_batch_size") {
+            sbd.pt2.batch_size = std::stoull(argv[i + 1]);
+            i++;
+        }
     }
     return sbd;
 }
 
-// energy, occupancy
-std::tuple<double, std::vector<double>>
-sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
+// Chooses the orbital labels of the determinant strings on rank 0, dets decoded
+// with one orbital per element. SBD splits the sorted strings by count, so "auto"
+// compares the estimated imbalance of that split for the input and clustered
+// orders; "cluster" needs no estimate.
+std::vector<size_t> plan_det_ordering(
+    const std::vector<std::vector<size_t>> &dets, size_t norb, int adet_comm_size,
+    int bdet_comm_size, const std::string &mode
+)
+{
+    std::vector<size_t> identity(norb);
+    std::iota(identity.begin(), identity.end(), 0);
+    std::vector<size_t> clustered = cluster_orbital_order(dets, norb);
+    if (mode != "auto") {
+        std::cout << " Determinant ordering: " << mode << std::endl;
+        return mode == "cluster" ? clustered : identity;
+    }
+
+    const size_t words = (norb + 63) / 64;
+    auto lex_packed = partition::pack_strings(dets, identity);
+    auto counts = connection_counts(lex_packed, norb);
+    auto lex_position = partition::sorted_positions(lex_packed, words);
+    auto cluster_position = partition::sorted_positions(
+        partition::pack_strings(dets, clustered), words
+    );
+
+    auto a_even = partition::even_boundaries(dets.size(), adet_comm_size);
+    auto b_even = partition::even_boundaries(dets.size(), bdet_comm_size);
+    auto lex = estimate_load(counts, lex_position, a_even, b_even);
+    auto cluster = estimate_load(counts, cluster_position, a_even, b_even);
+
+    bool use_cluster = cluster.max_cost < lex.max_cost;
+    std::cout << " Determinant ordering: " << (use_cluster ? "cluster" : "lex")
+              << ", estimated b_comm load imbalance (max/mean) lex "
+              << lex.imbalance() << ", cluster " << cluster.imbalance() << std::endl;
+    return use_cluster ? clustered : identity;
+}
+
+// Ground state in the determinant basis. Alpha and beta run over the same
+// strings, bit p set when orbital p (input labels) is occupied, and the
+// coefficient of (strings[i], strings[j]) is coefficients[i * strings.size() + j].
+struct Wavefunction {
+    std::vector<uint64_t> strings;
+    std::vector<double> coefficients;
+};
+
+// Collects on rank 0 of comm the blocks of W held by the ranks marked owner, one
+// copy of the adet_comm x bdet_comm grid, [a_begin, a_end) x [b_begin, b_end)
+// each with the alpha index slowest.
+void gather_wavefunction(
+    Wavefunction &wavefunction, const std::vector<double> &W,
+    const std::vector<std::vector<size_t>> &dets, size_t bit_length,
+    const std::vector<uint64_t> &orbital_order, size_t a_begin, size_t a_end,
+    size_t b_begin, size_t b_end, bool owner, MPI_Comm comm
+)
+{
+    int mpi_rank;
+    MPI_Comm_rank(comm, &mpi_rank);
+    int mpi_size;
+    MPI_Comm_size(comm, &mpi_size);
+    if (owner && W.size() != (a_end - a_begin) * (b_end - b_begin)) {
+        throw std::runtime_error("unexpected wave function layout for gathering");
+    }
+
+    const uint64_t bounds[5] = {owner ? 1U : 0U, a_begin, a_end, b_begin, b_end};
+    std::vector<uint64_t> all_bounds(mpi_rank == 0 ? 5 * mpi_size : 0);
+    MPI_Gather(bounds, 5, MPI_UINT64_T, all_bounds.data(), 5, MPI_UINT64_T, 0, comm);
+    const int send_count = owner ? static_cast<int>(W.size()) : 0;
+    std::vector<int> counts(mpi_size, 0), displs(mpi_size, 0);
+    MPI_Gather(&send_count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, comm);
+    std::vector<double> blocks;
+    if (mpi_rank == 0) {
+        for (int r = 1; r < mpi_size; ++r) {
+            displs[r] = displs[r - 1] + counts[r - 1];
+        }
+        blocks.resize(static_cast<size_t>(displs.back()) + counts.back());
+    }
+    MPI_Gatherv(
+        W.data(), send_count, MPI_DOUBLE, blocks.data(), counts.data(), displs.data(),
+        MPI_DOUBLE, 0, comm
+    );
+    if (mpi_rank != 0) {
+        return;
+    }
+
+    // Strings back in the input orbital labels. Putting the creation operators
+    // back in ascending input order gives each string the sign of that
+    // permutation, the parity of the inversions among its occupied orbitals.
+    const size_t n = dets.size();
+    wavefunction.strings.assign(n, 0);
+    std::vector<double> signs(n, 1.0);
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t str = pt2::to_uint64(dets[i], bit_length);
+        uint64_t &mapped = wavefunction.strings[i];
+        int inversions = 0;
+        for (size_t p = 0; p < orbital_order.size(); ++p) {
+            if ((str >> p) & 1) {
+                const uint64_t label = orbital_order[p];
+                const uint64_t above = ~((uint64_t(2) << label) - 1);
+                inversions += __builtin_popcountll(mapped & above);
+                mapped |= uint64_t(1) << label;
+            }
+        }
+        signs[i] = (inversions & 1) ? -1.0 : 1.0;
+    }
+    wavefunction.coefficients.assign(n * n, 0.0);
+    for (int r = 0; r < mpi_size; ++r) {
+        const uint64_t *bound = &all_bounds[5 * r];
+        if (bound[0] == 0) {
+            continue;
+        }
+        const double *block = blocks.data() + displs[r];
+        const size_t width = bound[4] - bound[3];
+        for (size_t a = bound[1]; a < bound[2]; ++a) {
+            const double *row = block + (a - bound[1]) * width;
+            for (size_t b = bound[3]; b < bound[4]; ++b) {
+                wavefunction.coefficients[a * n + b] =
+                    signs[a] * signs[b] * row[b - bound[3]];
+            }
+        }
+    }
+}
+
+// energy, occupancy, PT2 correction (zero unless sbd_data.pt2.enabled), excited
+// states (empty unless sbd_data.num_roots > 1). With wavefunction set, the ground
+// state is also gathered into it on rank 0 of comm; that needs at most 64
+// orbitals and a wave function that fits in memory on one rank.
+std::tuple<double, std::vector<double>, PT2Result, ExcitedStates> sbd_main(
+    const MPI_Comm &comm, const SBD &sbd_data, Wavefunction *wavefunction = nullptr
+)
 {
 
     double E = 0.0;
@@ -154,6 +336,10 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     sbd::oneInt<double> I1;
     sbd::twoInt<double> I2;
     sbd::SetupIntegrals(fcidump, L, N, I0, I1, I2);
+    // PT2 packs each spin string into one 64-bit word; fail before diagonalizing.
+    if (sbd_data.pt2.enabled && L > 64) {
+        throw std::invalid_argument("--pt2 supports at most 64 orbitals");
+    }
 
     /**
        Preparation of dets
@@ -162,8 +348,18 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     std::vector<std::vector<size_t>> adet;
     std::vector<std::vector<size_t>> bdet;
 
+    std::vector<uint64_t> orbital_order(L);
+    std::iota(orbital_order.begin(), orbital_order.end(), 0);
+
     if (mpi_rank == 0) {
         adet = sbd::DecodeAlphaDets(adetfile, L);
+        if (sbd_data.det_ordering != "lex") {
+            auto order = plan_det_ordering(
+                adet, L, adet_comm_size, bdet_comm_size, sbd_data.det_ordering
+            );
+            partition::permute_orbitals(adet, order);
+            std::copy(order.begin(), order.end(), orbital_order.begin());
+        }
         sbd::change_bitlength(1, adet, bit_length);
         sbd::sort_bitarray(adet);
     }
@@ -171,6 +367,27 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     sbd::MpiBcast(adet, 0, comm);
     bdet = adet;
 
+    // Relabeled strings need the integrals in the same orbital order; the
+    // permuted FCIDUMP is written next to the determinant file and also feeds PT2.
+    MPI_Bcast(orbital_order.data(), L, MPI_UINT64_T, 0, comm);
+    bool reordered = false;
+    for (int p = 0; p < L; ++p) {
+        reordered = reordered || orbital_order[p] != static_cast<uint64_t>(p);
+    }
+    if (reordered) {
+        if (mpi_rank == 0) {
+            auto integrals = ffsim::load_fcidump(fcidumpfile);
+            integrals.permute_orbitals(
+                std::vector<size_t>(orbital_order.begin(), orbital_order.end())
+            );
+            fcidumpfile = adetfile + ".fcidump";
+            ffsim::write_fcidump(integrals, fcidumpfile);
+            fcidump = sbd::LoadFCIDump(fcidumpfile);
+        }
+        sbd::MpiBcast(fcidump, 0, comm);
+        sbd::SetupIntegrals(fcidump, L, N, I0, I1, I2);
+    }
+
     /**
        Setup helpers
      */
@@ -206,26 +423,62 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     int mpi_size_h;
     MPI_Comm_size(h_comm, &mpi_size_h);
 
+    // Local block of W on this b_comm rank, alpha index slowest.
+    size_t a_begin = 0;
+    size_t a_end = adet.size();
+    size_t b_begin = 0;
+    size_t b_end = bdet.size();
+    sbd::get_mpi_range(adet_comm_size, mpi_rank_b / bdet_comm_size, a_begin, a_end);
+    sbd::get_mpi_range(bdet_comm_size, mpi_rank_b % bdet_comm_size, b_begin, b_end);
+    const size_t local_size = (a_end - a_begin) * (b_end - b_begin);
+    const auto placement = PagePlacement::parse(sbd_data.page_placement);
+
     /**
        Initialize/Load wave function
      */
-    std::vector<double> W;
+    std::vector<double> W = first_touch_vector(local_size, placement);
     sbd::BasisInitVector(
         W, adet, bdet, adet_comm_size, bdet_comm_size, h_comm, b_comm, t_comm, init
     );
     /**
        Diagonalization
      */
-    std::vector<double> hii;
+    std::vector<double> hii = first_touch_vector(local_size, placement);
     auto time_start_diag = std::chrono::high_resolution_clock::now();
     sbd::makeQChamDiagTerms(
         adet, bdet, bit_length, L, helper, I0, I1, I2, hii, h_comm, b_comm, t_comm
     );
-    sbd::Davidson(
-        hii, W, adet, bdet, bit_length, static_cast<size_t>(L), adet_comm_size,
-        bdet_comm_size, helper, I0, I1, I2, h_comm, b_comm, t_comm, max_it, max_nb, eps,
-        max_time
-    );
+    BlockDavidsonResult block;
+    if (sbd_data.num_roots > 1) {
+        // All roots in one subspace, every sigma build through the helpers above.
+        auto apply = [&](std::vector<double> &x, std::vector<double> &y) {
+            sbd::mult(
+                hii, x, y, adet, bdet, bit_length, static_cast<size_t>(L),
+                adet_comm_size, bdet_comm_size, helper, I0, I1, I2, h_comm, b_comm,
+                t_comm
+            );
+        };
+        // The BasisInitVector state leads the block, the lowest diagonal elements
+        // fill it up.
+        auto guesses = lowest_diagonal_guesses(hii, sbd_data.num_roots, b_comm);
+        guesses.insert(guesses.begin(), W);
+        block = block_davidson(
+            hii, guesses, sbd_data.num_roots, apply, b_comm, max_it * max_nb,
+            max_nb * sbd_data.num_roots, eps, max_time
+        );
+        W = block.vectors[0];
+        if (mpi_rank == 0) {
+            std::cout << " Block Davidson "
+                      << (block.converged ? "converged" : "stopped") << " after "
+                      << block.iterations << " iterations" << std::endl;
+        }
+    } else {
+        sbd::Davidson(
+            hii, W, adet, bdet, bit_length, static_cast<size_t>(L), adet_comm_size,
+            bdet_comm_size, helper, I0, I1, I2, h_comm, b_comm, t_comm, max_it, max_nb,
+            eps, max_time
+        );
+    }
     auto time_end_diag = std::chrono::high_resolution_clock::now();
     auto elapsed_diag_count = std::chrono::duration_cast<std::chrono::microseconds>(
                                   time_end_diag - time_start_diag
@@ -240,7 +493,7 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
          Evaluation of Hamiltonian expectation value
     */
 
-    std::vector<double> C(W.size(), 0.0);
+    std::vector<double> C = first_touch_vector(W.size(), placement);
 
     sbd::mult(
         hii, W, C, adet, bdet, bit_length, static_cast<size_t>(L), adet_comm_size,
@@ -248,6 +501,7 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     );
 
     sbd::InnerProduct(W, C, E, b_comm);
+    double E_variational = E;
 
     if (energy_target != 0.0 && std::abs(E - energy_target) > energy_variance) {
         E = 0.0;
@@ -268,27 +522,105 @@ sbd_main(const MPI_Comm &comm, const SBD &sbd_data)
     size_t o_size = o_end - o_start;
     std::vector<int> oIdx(o_size);
     std::iota(oIdx.begin(), oIdx.end(), o_start);
-    std::vector<double> res_density;
-    sbd::OccupationDensity(
-        oIdx, W, adet, bdet, bit_length, adet_comm_size, bdet_comm_size, b_comm,
-        res_density
-    );
-    std::vector<double> density_rank(static_cast<size_t>(2 * L), 0.0);
-    std::vector<double> density_group(static_cast<size_t>(2 * L), 0.0);
-    std::vector<double> density(static_cast<size_t>(2 * L), 0.0);
-    for (size_t io = o_start; io < o_end; io++) {
-        density_rank[2 * io] = res_density[2 * (io - o_start)];
-        density_rank[2 * io + 1] = res_density[2 * (io - o_start) + 1];
+    auto occupation_density = [&](const std::vector<double> &state) {
+        std::vector<double> res_density;
+        sbd::OccupationDensity(
+            oIdx, state, adet, bdet, bit_length, adet_comm_size, bdet_comm_size,
+            b_comm, res_density
+        );
+        std::vector<double> density_rank(static_cast<size_t>(2 * L), 0.0);
+        std::vector<double> density_group(static_cast<size_t>(2 * L), 0.0);
+        std::vector<double> density(static_cast<size_t>(2 * L), 0.0);
+        for (size_t io = o_start; io < o_end; io++) {
+            density_rank[2 * io] = res_density[2 * (io - o_start)];
+            density_rank[2 * io + 1] = res_density[2 * (io - o_start) + 1];
+        }
+        MPI_Allreduce(
+            density_rank.data(), density_group.data(), 2 * L, MPI_DOUBLE, MPI_SUM,
+            t_comm
+        );
+        MPI_Allreduce(
+            density_group.data(), density.data(), 2 * L, MPI_DOUBLE, MPI_SUM, h_comm
+        );
+        if (reordered) {
+            std::vector<double> relabeled(density.size());
+            for (int p = 0; p < L; ++p) {
+                relabeled[2 * orbital_order[p]] = density[2 * p];
+                relabeled[2 * orbital_order[p] + 1] = density[2 * p + 1];
+            }
+            density.swap(relabeled);
+        }
+        return density;
+    };
+    std::vector<double> density = occupation_density(W);
+    if (wavefunction != nullptr) {
+        if (L > 64) {
+            throw std::invalid_argument(
+                "wave function output needs at most 64 orbitals"
+            );
+        }
+        gather_wavefunction(
+            *wavefunction, W, adet, bit_length, orbital_order, a_begin, a_end, b_begin,
+            b_end, mpi_rank_h == 0 && mpi_rank_t == 0, comm
+        );
+    }
+
+    ExcitedStates excited;
+    for (size_t root = 1; root < block.vectors.size(); ++root) {
+        excited.energies.push_back(block.energies[root]);
+        excited.densities.push_back(occupation_density(block.vectors[root]));
+        if (mpi_rank == 0) {
+            std::cout << " Energy[" << root << "] = " << block.energies[root]
+                      << " , residual " << block.residuals[root] << std::endl;
+        }
+    }
+
+    /**
+       Epstein-Nesbet PT2 correction on top of the variational energy
+     */
+    PT2Result pt2;
+    if (sbd_data.pt2.enabled) {
+        auto time_start_pt2 = std::chrono::high_resolution_clock::now();
+        ffsim::FCIDump integrals;
+        if (mpi_rank == 0) {
+            integrals = ffsim::load_fcidump(fcidumpfile);
+            if (sbd_data.pt2.cholesky_tol > 0.0) {
+                integrals.factorize(sbd_data.pt2.cholesky_tol);
+            }
+        }
+        pt2::bcast_fcidump(integrals, 0, comm);
+
+        std::vector<uint64_t> alpha_strs(adet.size()), beta_strs(bdet.size());
+        for (size_t i = 0; i < adet.size(); ++i) {
+            alpha_strs[i] = pt2::to_uint64(adet[i], bit_length);
+        }
+        for (size_t i = 0; i < bdet.size(); ++i) {
+            beta_strs[i] = pt2::to_uint64(bdet[i], bit_length);
+        }
+
+        if (W.size() != local_size) {
+            throw std::runtime_error("unexpected wave function layout for PT2");
+        }
+
+        pt2 = epstein_nesbet_pt2(
+            integrals, E_variational, alpha_strs, beta_strs, W, a_begin, a_end, b_begin,
+            b_end, p_rank, p_size, sbd_data.pt2, comm
+        );
+        auto time_end_pt2 = std::chrono::high_resolution_clock::now();
+        auto elapsed_pt2_count = std::chrono::duration_cast<std::chrono::microseconds>(
+                                     time_end_pt2 - time_start_pt2
+        )
+                                     .count();
+        double elapsed_pt2 = 0.000001 * static_cast<double>(elapsed_pt2_count);
+        if (mpi_rank == 0) {
+            std::cout << " E_PT2 = " << pt2.energy << " +/- " << pt2.error
+                      << " , E_var + E_PT2 = " << E_variational + pt2.energy
+                      << " , elapsed " << elapsed_pt2 << " (sec) " << std::endl;
+        }
     }
-    MPI_Allreduce(
-        density_rank.data(), density_group.data(), 2 * L, MPI_DOUBLE, MPI_SUM, t_comm
-    );
-    MPI_Allreduce(
-        density_group.data(), density.data(), 2 * L, MPI_DOUBLE, MPI_SUM, h_comm
-    );
 
     FreeHelpers(helper);
-    return {E, density};
+    return {E, density, pt2, excited};
 }
 
 #endif
@@ -0,0 +1,473 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+#include "sqd_capi.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+#include "counts_helper.hpp"
+#include "ffsim/fcidump.hpp"
+#include "mixing_helper.hpp"
+#include "sbd_helper.hpp"
+#include "sqd_helper.hpp"
+
+// Session state; everything except the integrals, which SBD reads from the
+// FCIDUMP written into the work directory at creation.
+struct SqdSession {
+    SQD sqd;
+    SBD sbd;
+    uint64_t norb = 0;
+    std::pair<uint64_t, uint64_t> nelec;
+    bool gather_wavefunction = true;
+    bool owns_work_dir = false;
+
+    PackedCounts counts{0};
+    // Input of the next recovery iteration, in recovery order.
+    std::array<std::vector<double>, 2> occupancies;
+    AndersonMixer mixer{0, 1.0};
+    std::mt19937 rng;
+    std::mt19937 rc_rng;
+
+    uint64_t iterations = 0;
+    std::vector<double> energies;
+    std::vector<double> density; // last SBD density, interleaved alpha/beta
+    Wavefunction wavefunction;
+};
+
+namespace
+{
+
+thread_local std::string last_error;
+
+// Error raised for calls that are valid but not in the current session state.
+struct InvalidState : std::logic_error {
+    using std::logic_error::logic_error;
+};
+
+struct BufferTooSmall : std::length_error {
+    using std::length_error::length_error;
+};
+
+// Runs body, turning exceptions into exit codes and last_error.
+template <typename Body> SqdExitCode guarded(Body &&body)
+{
+    try {
+        last_error.clear();
+        body();
+        return SqdExitCode_Success;
+    } catch (const std::invalid_argument &e) {
+        last_error = e.what();
+        return SqdExitCode_InvalidArgument;
+    } catch (const InvalidState &e) {
+        last_error = e.what();
+        return SqdExitCode_InvalidState;
+    } catch (const BufferTooSmall &e) {
+        last_error = e.what();
+        return SqdExitCode_BufferTooSmall;
+    } catch (const std::exception &e) {
+        last_error = e.what();
+        return SqdExitCode_RuntimeError;
+    } catch (...) {
+        last_error = "unknown error";
+        return SqdExitCode_RuntimeError;
+    }
+}
+
+// Runs body on every rank of comm and returns the same exit code on all of
+// them, the largest raised on any rank. A rank that fails ahead of a collective
+// call then does not leave the others waiting in it.
+template <typename Body> SqdExitCode guarded_collective(MPI_Comm comm, Body &&body)
+{
+    const SqdExitCode local = guarded(body);
+    int code = local;
+    MPI_Allreduce(MPI_IN_PLACE, &code, 1, MPI_INT, MPI_MAX, comm);
+    if (code != SqdExitCode_Success && local == SqdExitCode_Success) {
+        last_error = "error raised on another rank";
+    }
+    return static_cast<SqdExitCode>(code);
+}
+
+void require(bool condition, const char *message)
+{
+    if (!condition) {
+        throw std::invalid_argument(message);
+    }
+}
+
+// Reports the size needed in size and checks the capacity it held. Returns
+// false for a null buffer, which only queries the size.
+bool fits(const void *buffer, size_t *size, size_t needed)
+{
+    require(size != nullptr, "null size");
+    const size_t capacity = *size;
+    *size = needed;
+    if (buffer == nullptr) {
+        return false;
+    }
+    if (capacity < needed) {
+        throw BufferTooSmall("buffer holds " + std::to_string(capacity) +
+                             " elements, " + std::to_string(needed) + " needed");
+    }
+    return true;
+}
+
+// Initializes MPI for callers that have not, finalizing it at exit.
+void ensure_mpi()
+{
+    int initialized;
+    MPI_Initialized(&initialized);
+    if (initialized) {
+        return;
+    }
+    int provided;
+    if (MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided) !=
+        MPI_SUCCESS) {
+        throw std::runtime_error("MPI_Init failed");
+    }
+    std::atexit([] {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized) {
+            MPI_Finalize();
+        }
+    });
+}
+
+// Fresh directory in the system temporary directory, unique to the process.
+std::filesystem::path make_work_dir()
+{
+    static std::atomic<uint64_t> counter{0};
+    const auto base = std::filesystem::temp_directory_path();
+    for (;;) {
+        auto dir = base / ("sqd_session_" + std::to_string(getpid()) + "_" +
+                           std::to_string(counter++));
+        if (std::filesystem::create_directory(dir)) {
+            return dir;
+        }
+    }
+}
+
+// Integrals in the packed 8-fold form of ffsim::FCIDump.
+ffsim::FCIDump make_fcidump(
+    uint64_t norb, const std::pair<uint64_t, uint64_t> &nelec, double ecore,
+    const double *h1, const double *eri
+)
+{
+    ffsim::FCIDump fcidump;
+    fcidump.norb = norb;
+    fcidump.nelec = nelec.first + nelec.second;
+    fcidump.ms2 =
+        static_cast<int64_t>(nelec.first) - static_cast<int64_t>(nelec.second);
+    fcidump.constant = ecore;
+    const auto n = static_cast<Eigen::Index>(norb);
+    fcidump.one_body =
+        Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                                       Eigen::RowMajor>>(h1, n, n);
+    fcidump.eri.assign(fcidump.npair() * (fcidump.npair() + 1) / 2, 0.0);
+    for (size_t p = 0; p < norb; ++p) {
+        for (size_t q = 0; q <= p; ++q) {
+            for (size_t r = 0; r < norb; ++r) {
+                for (size_t s = 0; s <= r; ++s) {
+                    const size_t pq = ffsim::pair_index(p, q);
+                    const size_t rs = ffsim::pair_index(r, s);
+                    if (rs <= pq) {
+                        fcidump.eri[ffsim::pair_index(pq, rs)] =
+                            eri[((p * norb + q) * norb + r) * norb + s];
+                    }
+                }
+            }
+        }
+    }
+    return fcidump;
+}
+
+} // namespace
+
+extern "C" {
+
+void sqd_options_default(SqdOptions *options)
+{
+    if (options == nullptr) {
+        return;
+    }
+    SQD sqd;
+    SBD sbd;
+    options->samples_per_batch = sqd.samples_per_batch;
+    options->seed = 1234;
+    options->with_hf = sqd.with_hf;
+    options->verbose = sqd.verbose;
+    options->occupancy_mixing = sqd.mixing.enabled;
+    options->mixing_history = sqd.mixing.history;
+    options->mixing_damping = sqd.mixing.damping;
+    options->task_comm_size = sbd.task_comm_size;
+    options->adet_comm_size = sbd.adet_comm_size;
+    options->bdet_comm_size = sbd.bdet_comm_size;
+    options->max_it = sbd.max_it;
+    options->max_nb = sbd.max_nb;
+    options->eps = sbd.eps;
+    options->max_time = sbd.max_time;
+    options->gather_wavefunction = 1;
+    options->work_dir = nullptr;
+}
+
+const char *sqd_last_error(void)
+{
+    return last_error.c_str();
+}
+
+SqdExitCode sqd_session_new(
+    const SqdOptions *options, uint64_t norb, uint64_t n_alpha, uint64_t n_beta,
+    double ecore, const double *h1, const double *eri, const MPI_Comm *comm,
+    SqdSession **session
+)
+{
+    SqdExitCode code = guarded(ensure_mpi);
+    if (code != SqdExitCode_Success) {
+        return code;
+    }
+    std::unique_ptr<SqdSession> s;
+    code = guarded_collective(comm != nullptr ? *comm : MPI_COMM_WORLD, [&] {
+        require(options != nullptr && session != nullptr, "null argument");
+        require(norb > 0 && n_alpha <= norb && n_beta <= norb, "bad electron count");
+        s = std::make_unique<SqdSession>();
+        s->norb = norb;
+        s->nelec = {n_alpha, n_beta};
+        s->gather_wavefunction = options->gather_wavefunction != 0;
+
+        s->sqd.comm = comm != nullptr ? *comm : MPI_COMM_WORLD;
+        MPI_Comm_rank(s->sqd.comm, &s->sqd.mpi_rank);
+        MPI_Comm_size(s->sqd.comm, &s->sqd.mpi_size);
+        s->sqd.run_id = "session";
+        s->sqd.samples_per_batch = options->samples_per_batch;
+        s->sqd.with_hf = options->with_hf != 0;
+        s->sqd.verbose = options->verbose != 0 && s->sqd.mpi_rank == 0;
+        s->sqd.mixing = {
+            options->occupancy_mixing != 0, options->mixing_history,
+            options->mixing_damping
+        };
+        s->mixer = AndersonMixer(s->sqd.mixing.history, s->sqd.mixing.damping);
+        s->rng.seed(static_cast<std::mt19937::result_type>(options->seed));
+        s->rc_rng.seed(s->rng());
+
+        s->sbd.task_comm_size = options->task_comm_size;
+        s->sbd.adet_comm_size = options->adet_comm_size;
+        s->sbd.bdet_comm_size = options->bdet_comm_size;
+        s->sbd.max_it = options->max_it;
+        s->sbd.max_nb = options->max_nb;
+        s->sbd.eps = options->eps;
+        s->sbd.max_time = options->max_time;
+        s->sbd.energy_target = 0.0; // no reference energy to screen against
+
+        // SBD loads its integrals and determinants from files, so rank 0 keeps
+        // them in the work directory; all data crossing this interface stays in
+        // memory.
+        if (s->sqd.mpi_rank == 0) {
+            require(h1 != nullptr && eri != nullptr, "null integrals on rank 0");
+            std::filesystem::path dir;
+            if (options->work_dir != nullptr && options->work_dir[0] != '\0') {
+                dir = options->work_dir;
+                std::filesystem::create_directories(dir);
+            } else {
+                dir = make_work_dir();
+                s->owns_work_dir = true;
+            }
+            s->sqd.work_dir = dir.string();
+            s->sbd.fcidumpfile = (dir / "FCIDUMP").string();
+            ffsim::write_fcidump(
+                make_fcidump(norb, s->nelec, ecore, h1, eri), s->sbd.fcidumpfile
+            );
+        }
+
+        s->counts = PackedCounts(2 * norb);
+        std::vector<double> alpha(norb, 0.0), beta(norb, 0.0);
+        std::fill_n(alpha.begin(), n_alpha, 1.0);
+        std::fill_n(beta.begin(), n_beta, 1.0);
+        s->occupancies = to_recovery_order({alpha, beta});
+    });
+    if (code == SqdExitCode_Success) {
+        *session = s.release();
+    } else {
+        sqd_session_free(s.release());
+    }
+    return code;
+}
+
+void sqd_session_free(SqdSession *session)
+{
+    if (session == nullptr) {
+        return;
+    }
+    if (session->owns_work_dir) {
+        std::error_code ignored;
+        std::filesystem::remove_all(session->sqd.work_dir, ignored);
+    }
+    delete session;
+}
+
+SqdExitCode sqd_session_push_counts(
+    SqdSession *session, const uint64_t *shots, const uint64_t *counts,
+    size_t num_shots
+)
+{
+    return guarded([&] {
+        require(session != nullptr, "null session");
+        require(shots != nullptr || num_shots == 0, "null shots");
+        const size_t words = session->counts.words();
+        for (size_t i = 0; i < num_shots; ++i) {
+            session->counts.add(&shots[i * words], counts != nullptr ? counts[i] : 1);
+        }
+    });
+}
+
+SqdExitCode sqd_session_clear_counts(SqdSession *session)
+{
+    return guarded([&] {
+        require(session != nullptr, "null session");
+        session->counts = PackedCounts(2 * session->norb);
+    });
+}
+
+SqdExitCode sqd_session_set_occupancies(
+    SqdSession *session, const double *alpha, const double *beta
+)
+{
+    return guarded([&] {
+        require(
+            session != nullptr && alpha != nullptr && beta != nullptr, "null argument"
+        );
+        const size_t norb = session->norb;
+        session->occupancies = to_recovery_order(
+            {std::vector<double>(alpha, alpha + norb),
+             std::vector<double>(beta, beta + norb)}
+        );
+    });
+}
+
+SqdExitCode sqd_session_run(SqdSession *session, uint64_t n_iterations)
+{
+    if (session == nullptr) {
+        return guarded([] { require(false, "null session"); });
+    }
+    auto &s = *session;
+    // Recovery runs on rank 0; the others only follow its occupancies. Each step
+    // ends with the ranks agreeing on its exit code, so an error on rank 0 stops
+    // every rank before SBD.
+    std::vector<boost::dynamic_bitset<>> bitstrings;
+    std::vector<double> probabilities;
+    SqdExitCode code = guarded_collective(s.sqd.comm, [&] {
+        bcast_occupancies(s.occupancies, s.sqd.comm);
+        uint64_t num_shots = s.counts.total();
+        MPI_Bcast(&num_shots, 1, MPI_UINT64_T, 0, s.sqd.comm);
+        if (num_shots == 0) {
+            throw InvalidState("no shots pushed on rank 0");
+        }
+        if (s.sqd.mpi_rank == 0) {
+            std::tie(bitstrings, probabilities) = s.counts.to_arrays();
+        }
+    });
+    for (uint64_t i = 0; i < n_iterations && code == SqdExitCode_Success;
+         ++i, ++s.iterations) {
+        code = guarded_collective(s.sqd.comm, [&] {
+            log(s.sqd, {"start recovery: iteration=", std::to_string(s.iterations)});
+            if (s.sqd.mpi_rank == 0) {
+                s.sbd.adetfile = recover_alphadets(
+                    s.sqd, bitstrings, probabilities, s.occupancies, s.norb, s.nelec,
+                    s.iterations, s.rng, s.rc_rng
+                );
+            }
+        });
+        if (code != SqdExitCode_Success) {
+            break;
+        }
+        const bool last = i + 1 == n_iterations;
+        code = guarded_collective(s.sqd.comm, [&] {
+            auto [energy, density, pt2, excited] = sbd_main(
+                s.sqd.comm, s.sbd,
+                last && s.gather_wavefunction && s.norb <= 64 ? &s.wavefunction
+                                                             : nullptr
+            );
+            log(s.sqd, {"energy: ", std::to_string(energy)});
+            s.energies.push_back(energy);
+            update_occupancies(s.sqd, s.occupancies, density, s.mixer);
+            s.density = std::move(density);
+        });
+    }
+    return code;
+}
+
+SqdExitCode
+sqd_session_energies(const SqdSession *session, double *energies, size_t *size)
+{
+    return guarded([&] {
+        require(session != nullptr, "null session");
+        if (fits(energies, size, session->energies.size())) {
+            std::copy(session->energies.begin(), session->energies.end(), energies);
+        }
+    });
+}
+
+SqdExitCode sqd_session_occupancies(
+    const SqdSession *session, double *alpha, double *beta
+)
+{
+    return guarded([&] {
+        require(
+            session != nullptr && alpha != nullptr && beta != nullptr, "null argument"
+        );
+        if (session->density.empty()) {
+            throw InvalidState("no iteration has run");
+        }
+        for (size_t p = 0; p < session->norb; ++p) {
+            alpha[p] = session->density[2 * p];
+            beta[p] = session->density[2 * p + 1];
+        }
+    });
+}
+
+SqdExitCode sqd_session_wavefunction(
+    const SqdSession *session, uint64_t *strings, double *coefficients,
+    size_t *num_strings
+)
+{
+    return guarded([&] {
+        require(session != nullptr, "null session");
+        const auto &wavefunction = session->wavefunction;
+        if (wavefunction.strings.empty()) {
+            throw InvalidState("no wave function kept on this rank");
+        }
+        if (!fits(strings, num_strings, wavefunction.strings.size())) {
+            return;
+        }
+        require(coefficients != nullptr, "null coefficients");
+        std::copy(wavefunction.strings.begin(), wavefunction.strings.end(), strings);
+        std::copy(
+            wavefunction.coefficients.begin(), wavefunction.coefficients.end(),
+            coefficients
+        );
+    });
+}
+
+} // extern "C"
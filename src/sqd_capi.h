@@ -0,0 +1,173 @@
+/*
+# This code is part of Qiskit.
+#
+# (C) Copyright IBM 2025.
+#
+# This code is licensed under the Apache License, Version 2.0. You may
+# obtain a copy of this license in the LICENSE.txt file in the root directory
+# of this source tree or at http://www.apache.org/licenses/LICENSE-2.0.
+#
+# Any modifications or derivative works of this code must retain this
+# copyright notice, and modified files need to carry a notice indicating
+# that they have been altered from the originals.
+*/
+
+/*
+ * C interface to the classical part of the SQD workflow: configuration
+ * recovery, subsampling and SBD diagonalization, driven from in-memory buffers.
+ *
+ * A session holds the integrals of one problem, the shots pushed so far and the
+ * occupancies carried between recovery iterations. A typical caller
+ *
+ *     SqdOptions options;
+ *     sqd_options_default(&options);
+ *     SqdSession *session;
+ *     sqd_session_new(&options, norb, n_alpha, n_beta, ecore, h1, eri, NULL,
+ *                     &session);
+ *     sqd_session_push_counts(session, shots, counts, num_shots);
+ *     sqd_session_run(session, 3);
+ *     sqd_session_energies(session, energies, &size);
+ *     sqd_session_free(session);
+ *
+ * Sessions live on the ranks of an MPI communicator. sqd_session_new,
+ * sqd_session_run and sqd_session_free are collective and must be called on
+ * every rank; the other functions are local. Configuration recovery runs on rank
+ * 0, so the shots and occupancies given there are the ones used.
+ *
+ * Every function returns SqdExitCode_Success or an error code, with a
+ * description of the last error of the calling thread in sqd_last_error().
+ * Collective calls return the same code on every rank, and ranks that did not
+ * raise the error report it as raised on another rank. An error inside SBD
+ * itself may still leave the other ranks waiting; the session should not be
+ * used after a failed collective call.
+ *
+ * Size arguments of the output functions are in/out: the capacity of the
+ * buffers on input, the number of elements needed on output. Passing NULL
+ * buffers only queries the size.
+ */
+
+#ifndef SQD_CAPI_H_
+#define SQD_CAPI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mpi.h"
+
+#if defined(_WIN32) && defined(SQD_CAPI_BUILD)
+#define SQD_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define SQD_API __declspec(dllimport)
+#else
+#define SQD_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SqdExitCode_Success = 0,
+    SqdExitCode_InvalidArgument = 1, // null pointer, wrong size or bad option
+    SqdExitCode_InvalidState = 2,    // e.g. running without shots
+    SqdExitCode_BufferTooSmall = 3,  // size now holds the required capacity
+    SqdExitCode_RuntimeError = 4,    // failure in recovery, SBD, MPI or I/O
+} SqdExitCode;
+
+// Settings of a session; sqd_options_default fills in the values of the
+// command-line workflow.
+typedef struct {
+    // Configuration recovery
+    uint64_t samples_per_batch; // configurations kept by subsampling
+    uint64_t seed;              // seeds subsampling and, derived, recovery
+    int with_hf;                // always include the Hartree-Fock determinant
+    int verbose;                // progress messages on stdout
+    int occupancy_mixing;       // Anderson mixing of occupancies between iterations
+    int mixing_history;
+    double mixing_damping;
+
+    // SBD diagonalization
+    int task_comm_size;
+    int adet_comm_size;
+    int bdet_comm_size;
+    int max_it;
+    int max_nb;
+    double eps;
+    double max_time;
+    int gather_wavefunction; // keep the ground state on rank 0
+
+    // Directory for the SBD input files of the session; NULL or "" creates one
+    // in the system temporary directory, removed with the session.
+    const char *work_dir;
+} SqdOptions;
+
+typedef struct SqdSession SqdSession;
+
+SQD_API void sqd_options_default(SqdOptions *options);
+
+// Description of the last error on the calling thread, "" if none. The string
+// stays valid until the next call on that thread.
+SQD_API const char *sqd_last_error(void);
+
+// Creates a session for norb spatial orbitals and (n_alpha, n_beta) electrons
+// with the integrals of an FCIDUMP: the constant ecore, h_pq at h1[p * norb + q]
+// and (pq|rs), in chemists' notation, at eri[((p * norb + q) * norb + r) * norb
+// + s]. Only rank 0 reads h1 and eri, which may be NULL elsewhere. comm selects
+// the communicator, MPI_COMM_WORLD if NULL; MPI is initialized if it was not.
+// The initial occupancies are those of Hartree-Fock.
+SQD_API SqdExitCode sqd_session_new(
+    const SqdOptions *options, uint64_t norb, uint64_t n_alpha, uint64_t n_beta,
+    double ecore, const double *h1, const double *eri, const MPI_Comm *comm,
+    SqdSession **session
+);
+
+// Releases a session and its work directory; NULL is ignored.
+SQD_API void sqd_session_free(SqdSession *session);
+
+// Adds num_shots bitstrings of 2 * norb qubits, alpha orbitals first, packed as
+// (2 * norb + 63) / 64 words each with qubit q at bit q % 64 of word q / 64.
+// counts holds the multiplicity of each bitstring, 1 if NULL.
+SQD_API SqdExitCode sqd_session_push_counts(
+    SqdSession *session, const uint64_t *shots, const uint64_t *counts,
+    size_t num_shots
+);
+
+// Forgets all pushed shots.
+SQD_API SqdExitCode sqd_session_clear_counts(SqdSession *session);
+
+// Replaces the occupancies that seed the next recovery iteration, norb values
+// per spin with orbital 0 first.
+SQD_API SqdExitCode sqd_session_set_occupancies(
+    SqdSession *session, const double *alpha, const double *beta
+);
+
+// Runs n_iterations recovery iterations on the pushed shots, each one
+// recovering configurations, subsampling a batch and diagonalizing in it,
+// continuing from the occupancies left by the previous call.
+SQD_API SqdExitCode sqd_session_run(SqdSession *session, uint64_t n_iterations);
+
+// Ground-state energy of every iteration run so far, in order.
+SQD_API SqdExitCode
+sqd_session_energies(const SqdSession *session, double *energies, size_t *size);
+
+// Orbital occupancies of the last iteration's ground state, norb values per
+// spin with orbital 0 first.
+SQD_API SqdExitCode sqd_session_occupancies(
+    const SqdSession *session, double *alpha, double *beta
+);
+
+// Ground state of the last iteration on rank 0, kept when gather_wavefunction
+// is set and norb <= 64: num_strings determinant strings, bit p set when
+// orbital p is occupied, and coefficients[i * num_strings + j] of alpha string i
+// and beta string j. num_strings is in/out as size; coefficients must hold its
+// square.
+SQD_API SqdExitCode sqd_session_wavefunction(
+    const SqdSession *session, uint64_t *strings, double *coefficients,
+    size_t *num_strings
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SQD_CAPI_H_
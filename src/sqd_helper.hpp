@@ -15,7 +15,9 @@
 #ifndef SQD_HELPER_HPP_
 #define SQD_HELPER_HPP_
 
+#include <array>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <random>
@@ -28,6 +30,12 @@
 #include <cmath>
 
 #include "boost/dynamic_bitset.hpp"
+#include "counts_helper.hpp"
+#include "ffsim/fcidump.hpp"
+#include "mitigation_helper.hpp"
+#include "mixing_helper.hpp"
+#include "qiskit/addon/sqd/configuration_recovery.hpp"
+#include "qiskit/addon/sqd/subsampling.hpp"
 
 #include "mpi.h"
 #include "sbd/sbd.h"
@@ -101,7 +109,23 @@ struct SQD {
     bool with_hf = true;               // use Hartree-Fock as a reference state
 
     std::string backend_name = "";
+    // Shots of a USE_RANDOM_SHOTS build: "uniform" or "slater" (orbital-rotated HF)
+    std::string mock_sampler = "uniform";
     uint64_t num_shots = 10000;
+    std::string lucj_params = "file"; // LUCJ parameter source: "file" or "mp2"
+    // Recovery prior source: "file", "lucj" (simulated state) or "mp2"
+    std::string initial_occupancies = "file";
+    std::string input_bundle = "";       // pre-converted binary inputs, read on rank 0
+    std::string write_input_bundle = ""; // where to save the inputs as a bundle
+    ReadoutMitigation mitigation;
+    StreamingCounts streaming;
+    OccupancyMixing mixing;
+    std::string sampler_cache = "sampler_cache"; // cached shots; "" disables
+    bool fresh_samples = false; // resubmit even when the shots are cached
+    std::string work_dir = "";  // where SBD inputs are written; "" is the cwd
+    // Tolerance of the Cholesky factorization of the two-electron integrals read
+    // for MP2 and PT2; 0 keeps them dense.
+    double cholesky_tol = 0.0;
 
     MPI_Comm comm;
     int mpi_rank;
@@ -116,6 +140,15 @@ struct SQD {
         ss << "# samples_per_batch: " << samples_per_batch << std::endl;
         ss << "# backend_name: " << backend_name << std::endl;
         ss << "# num_shots: " << num_shots << std::endl;
+        ss << "# lucj_params: " << lucj_params << std::endl;
+        ss << "# initial_occupancies: " << initial_occupancies << std::endl;
+        ss << "# input_bundle: " << input_bundle << std::endl;
+        ss << "# readout_mitigation: " << mitigation.enabled << std::endl;
+        ss << "# counts_capacity: " << streaming.capacity << std::endl;
+        ss << "# occupancy_mixing: " << mixing.enabled << std::endl;
+        ss << "# sampler_cache: " << sampler_cache << std::endl;
+        ss << "# fresh_samples: " << fresh_samples << std::endl;
+        ss << "# cholesky_tol: " << cholesky_tol << std::endl;
         return ss.str();
     }
 };
@@ -141,6 +174,21 @@ void error(const SQD &sqd_data, const std::vector<std::string> &messages)
     }
 }
 
+// Loads FCIDUMP integrals, replacing the packed two-electron integrals by their
+// Cholesky vectors when --cholesky_tol is set.
+ffsim::FCIDump load_integrals(const SQD &sqd_data, const std::string &filename)
+{
+    auto fcidump = ffsim::load_fcidump(filename);
+    if (sqd_data.cholesky_tol > 0.0) {
+        fcidump.factorize(sqd_data.cholesky_tol);
+        log(sqd_data, {"two-electron integrals factorized: ",
+                       std::to_string(fcidump.cholesky_vecs.size()),
+                       " Cholesky vectors for ", std::to_string(fcidump.norb),
+                       " orbitals"});
+    }
+    return fcidump;
+}
+
 SQD generate_sqd_data(int argc, char *argv[])
 {
     SQD sqd;
@@ -157,14 +205,91 @@ SQD generate_sqd_data(int argc, char *argv[])
             sqd.backend_name = std::string(argv[i + 1]);
             i++;
         }
+        if (std::string(argv[i]) == "--mock_sampler") {
+            sqd.mock_sampler = std::string(argv[i + 1]);
+            i++;
+        }
         if (std::string(argv[i]) == "--num_shots") {
             sqd.num_shots = std::stoi(argv[i + 1]);
             i++;
         }
+        if (std::string(argv[i]) == "--lucj_params") {
+            sqd.lucj_params = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--initial_occupancies") {
+            sqd.initial_occupancies = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--input_bundle") {
+            sqd.input_bundle = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--write_input_bundle") {
+            sqd.write_input_bundle = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--readout_mitigation") {
+            sqd.mitigation.enabled = true;
+        }
+        if (std::string(argv[i]) == "--mitigation_distance") {
+            sqd.mitigation.distance = std::stoi(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--calibration_shots") {
+            sqd.mitigation.calibration_shots = std::stoi(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--counts_capacity") {
+            sqd.streaming.capacity = std::stoull(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--counts_chunk_shots") {
+            sqd.streaming.chunk_shots = std::stoull(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--occupancy_mixing") {
+            sqd.mixing.enabled = true;
+        }
+        if (std::string(argv[i]) == "--mixing_history") {
+            sqd.mixing.history = std::stoi(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--mixing_damping") {
+            sqd.mixing.damping = std::stod(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--sampler_cache") {
+            sqd.sampler_cache = std::string(argv[i + 1]);
+            i++;
+        }
+        if (std::string(argv[i]) == "--fresh_samples") {
+            sqd.fresh_samples = true;
+        }
+        if (std::string(argv[i]) == "--cholesky_tol") {
+            sqd.cholesky_tol = std::stod(argv[i + 1]);
+            i++;
+        }
         if (std::string(argv[i]) == "-v") {
             sqd.verbose = true;
         }
     }
+    if (sqd.lucj_params != "file" && sqd.lucj_params != "mp2") {
+        throw std::invalid_argument(
+            "unknown --lucj_params source: " + sqd.lucj_params +
+            " (expected file or mp2)"
+        );
+    }
+    if (sqd.initial_occupancies != "file" && sqd.initial_occupancies != "lucj" &&
+        sqd.initial_occupancies != "mp2") {
+        throw std::invalid_argument(
+            "unknown --initial_occupancies mode: " + sqd.initial_occupancies +
+            " (expected file, lucj or mp2)"
+        );
+    }
+    if (sqd.cholesky_tol < 0.0) {
+        throw std::invalid_argument("--cholesky_tol must not be negative");
+    }
     return sqd;
 }
 
@@ -264,9 +389,99 @@ std::string write_alphadets_file(
     }
     auto bytestrings = ci_strs_to_bytes(unique_ci_strs, static_cast<int>(norb));
     std::string alphadets_bin_file =
-        "AlphaDets_" + sqd_data.run_id + "_" + std::to_string(i_recovery) + "_cpp.bin";
+        (std::filesystem::path(sqd_data.work_dir) /
+         ("AlphaDets_" + sqd_data.run_id + "_" + std::to_string(i_recovery) +
+          "_cpp.bin"))
+            .string();
     write_bytestrings_to_file(bytestrings, alphadets_bin_file);
     return alphadets_bin_file;
 }
 
+// Reverse alpha/beta occupancies given orbital 0 first to match the internal
+// right-to-left convention used by configuration recovery.
+std::array<std::vector<double>, 2>
+to_recovery_order(std::array<std::vector<double>, 2> occupancies)
+{
+    std::reverse(occupancies[0].begin(), occupancies[0].end());
+    std::reverse(occupancies[1].begin(), occupancies[1].end());
+    return occupancies;
+}
+
+// Broadcast alpha/beta occupancies held by rank 0 to all ranks.
+void bcast_occupancies(std::array<std::vector<double>, 2> &occupancies, MPI_Comm comm)
+{
+    for (auto &occupancy : occupancies) {
+        int size = static_cast<int>(occupancy.size());
+        MPI_Bcast(&size, 1, MPI_INT, 0, comm);
+        occupancy.resize(size);
+        MPI_Bcast(occupancy.data(), size, MPI_DOUBLE, 0, comm);
+    }
+}
+
+// Rank 0 part of a recovery iteration: recovers physically consistent
+// configurations from the observed bitstrings and the current occupancies,
+// subsamples one batch of samples_per_batch and writes it as the SBD
+// determinant file of iteration i_recovery. Returns the path of that file.
+std::string recover_alphadets(
+    const SQD &sqd_data, const std::vector<boost::dynamic_bitset<>> &bitstrings,
+    const std::vector<double> &probabilities,
+    const std::array<std::vector<double>, 2> &occupancies, size_t norb,
+    const std::pair<uint64_t, uint64_t> &nelec, size_t i_recovery, std::mt19937 &rng,
+    std::mt19937 &rc_rng
+)
+{
+    auto [recovered_bitstrings, recovered_probabilities] =
+        Qiskit::addon::sqd::recover_configurations(
+            bitstrings, probabilities, occupancies, {nelec.first, nelec.second}, rc_rng
+        );
+    log(sqd_data, {"Number of recovered bitstrings: ",
+                   std::to_string(recovered_bitstrings.size())});
+
+    // Subsample to a single batch of fixed size for SBD, to cap IO/compute per
+    // iteration.
+    std::vector<boost::dynamic_bitset<>> batch;
+    Qiskit::addon::sqd::subsample(
+        batch, recovered_bitstrings, recovered_probabilities,
+        sqd_data.samples_per_batch, rng
+    );
+    return write_alphadets_file(
+        sqd_data, norb, nelec.first, batch, sqd_data.samples_per_batch * 2, i_recovery
+    );
+}
+
+// Feeds the SBD density (interleaved alpha/beta, orbital 0 first) back as the
+// occupancies of the next iteration, through the Anderson mixer when
+// --occupancy_mixing is set. Returns the max-norm of the occupancy residual.
+double update_occupancies(
+    const SQD &sqd_data, std::array<std::vector<double>, 2> &occupancies,
+    const std::vector<double> &density, AndersonMixer &mixer
+)
+{
+    if (2 * occupancies[0].size() != density.size()) {
+        throw std::invalid_argument("density does not match the occupancies");
+    }
+    // Input x of this iteration and the SBD density F(x), alpha then beta.
+    const auto n_occ = static_cast<Eigen::Index>(occupancies[0].size());
+    Eigen::VectorXd x(2 * n_occ), fx(2 * n_occ);
+    for (Eigen::Index j = 0; j < n_occ; ++j) {
+        x(j) = occupancies[0][j];
+        x(n_occ + j) = occupancies[1][j];
+        fx(j) = density[2 * j];             // alpha orbital
+        fx(n_occ + j) = density[2 * j + 1]; // beta orbital
+    }
+    const double residual = (fx - x).lpNorm<Eigen::Infinity>();
+    log(sqd_data, {"occupancy residual: ", std::to_string(residual)});
+    if (sqd_data.mixing.enabled) {
+        // Extrapolated occupancies, clipped to the physical range.
+        fx = mixer.next(x, fx).cwiseMax(0.0).cwiseMin(1.0);
+        log(sqd_data, {"occupancy mixing history: ",
+                       std::to_string(mixer.history_size())});
+    }
+    for (Eigen::Index j = 0; j < n_occ; ++j) {
+        occupancies[0][j] = fx(j);
+        occupancies[1][j] = fx(n_occ + j);
+    }
+    return residual;
+}
+
 #endif